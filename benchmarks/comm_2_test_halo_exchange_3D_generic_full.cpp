@@ -17,6 +17,8 @@
 #include <fstream>
 #include <iomanip>
 #include <array>
+#include <vector>
+#include <limits>
 
 #include "../utils/triplet.hpp"
 
@@ -164,6 +166,25 @@ namespace halo_exchange_3D_generic_full {
 #endif
         // communication object
         auto co = gridtools::ghex::make_communication_object<decltype(pattern_1)>(comm);
+#ifdef GHEX_DATATYPE_BENCHMARK
+        // send directly from field memory using MPI derived datatypes
+        co.use_mpi_datatypes(true);
+#endif
+#ifdef GHEX_PARALLEL_PACK_BENCHMARK
+        // pack and unpack with all OpenMP threads
+        co.use_parallel_packing(true);
+#endif
+#ifdef GHEX_COMPRESSION_BENCHMARK
+        // compress messages of at least 4 KiB
+        co.use_compression(true);
+#endif
+#ifdef GHEX_STREAMING_BENCHMARK
+        // pack all buffers with non-temporal stores
+        gridtools::ghex::streaming_stores::threshold() = 0u;
+#elif defined(GHEX_COMPUTE_BENCHMARK)
+        // reference: pack all buffers through the cache
+        gridtools::ghex::streaming_stores::threshold() = std::numeric_limits<std::size_t>::max();
+#endif
 
 
         file << "Proc: (" << coords[0] << ", " << coords[1] << ", " << coords[2] << ")\n";
@@ -280,12 +301,28 @@ namespace halo_exchange_3D_generic_full {
             timer_type t_1_global;
             timer_type t_global;
             const int k_start = 5;
+#ifdef GHEX_PERSISTENT_BENCHMARK
+            // set up buffers and persistent requests once
+            auto plan = co.make_exchange_plan(
+#ifndef GHEX_1_PATTERN_BENCHMARK
+                pattern_1(field1),
+                pattern_2(field2),
+                pattern_3(field3));
+#else
+                pattern_1(field1),
+                pattern_1(field2),
+                pattern_1(field3));
+#endif
+#endif
             for (int k=0; k<25; ++k)
             {
                 timer_type t_0;
                 timer_type t_1;
                 MPI_Barrier(context.mpi_comm());
                 t_0.tic();
+#ifdef GHEX_PERSISTENT_BENCHMARK
+                auto h = plan.exchange();
+#else
                 auto h = co.exchange(
 #ifndef GHEX_1_PATTERN_BENCHMARK
                     pattern_1(field1),
@@ -295,6 +332,7 @@ namespace halo_exchange_3D_generic_full {
                     pattern_1(field1),
                     pattern_1(field2),
                     pattern_1(field3));
+#endif
 #endif
                 t_0.toc();
                 t_1.tic();
@@ -370,6 +408,11 @@ namespace halo_exchange_3D_generic_full {
                 << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.min()/1000.0
                 << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.max()/1000.0
                 << std::endl;
+#ifdef GHEX_COMPRESSION_BENCHMARK
+            file << "COMPRESSION RATIO: "
+                << std::fixed << std::setprecision(3) << co.get_compression_statistics().ratio()
+                << std::endl;
+#endif
 
 #ifdef __CUDACC__
             GT_CUDA_CHECK(cudaMemcpy(a.data(),
@@ -424,12 +467,45 @@ namespace halo_exchange_3D_generic_full {
             timer_type t_1_global;
             timer_type t_global;
             const int k_start = 5;
+#ifdef GHEX_COMPUTE_BENCHMARK
+            // interior stencil computed after each exchange: its run time shows how much of the interior
+            // working set was evicted from the cache by packing and unpacking
+            timer_type t_2_local;
+            timer_type t_2_global;
+            std::vector<double> interior(DIM1*DIM2*DIM3, 0.0);
+            auto compute = [&]()
+            {
+                for (int kk = 1; kk < DIM3-1; ++kk)
+                    for (int jj = 1; jj < DIM2-1; ++jj)
+                        for (int ii = 1; ii < DIM1-1; ++ii)
+                            interior[(kk*DIM2+jj)*DIM1+ii] = 0.5*interior[(kk*DIM2+jj)*DIM1+ii] +
+                                field1(ii-1,jj,kk).x() + field1(ii+1,jj,kk).x() +
+                                field1(ii,jj-1,kk).x() + field1(ii,jj+1,kk).x() +
+                                field1(ii,jj,kk-1).x() + field1(ii,jj,kk+1).x() - 6*field1(ii,jj,kk).x();
+            };
+#endif
+#ifdef GHEX_PERSISTENT_BENCHMARK
+            // set up buffers and persistent requests once
+            auto plan = co.make_exchange_plan(
+#ifndef GHEX_1_PATTERN_BENCHMARK
+                pattern_1(field1),
+                pattern_2(field2),
+                pattern_3(field3));
+#else
+                pattern_1(field1),
+                pattern_1(field2),
+                pattern_1(field3));
+#endif
+#endif
             for (int k=0; k<25; ++k)
             {
                 timer_type t_0;
                 timer_type t_1;
                 MPI_Barrier(context.mpi_comm());
                 t_0.tic();
+#ifdef GHEX_PERSISTENT_BENCHMARK
+                auto h = plan.exchange();
+#else
                 auto h = co.exchange(
 #ifndef GHEX_1_PATTERN_BENCHMARK
                     pattern_1(field1),
@@ -439,11 +515,18 @@ namespace halo_exchange_3D_generic_full {
                     pattern_1(field1),
                     pattern_1(field2),
                     pattern_1(field3));
+#endif
 #endif
                 t_0.toc();
                 t_1.tic();
                 h.wait();
                 t_1.toc();
+#ifdef GHEX_COMPUTE_BENCHMARK
+                timer_type t_2;
+                t_2.tic();
+                compute();
+                t_2.toc();
+#endif
                 MPI_Barrier(context.mpi_comm());
 
                 timer_type t;
@@ -461,6 +544,22 @@ namespace halo_exchange_3D_generic_full {
                     t_1_global(t_1_all);
                     t_global(t_all);
                 }
+#ifdef GHEX_COMPUTE_BENCHMARK
+                auto t_2_all = gridtools::ghex::reduce(t_2,context.mpi_comm());
+                if (k >= k_start)
+                {
+                    t_2_local(t_2);
+                    t_2_global(t_2_all);
+                }
+                file << "TIME COMPUTE:     "
+                    << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2.mean()/1000.0
+                    << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_all.mean()/1000.0
+                    << " ±"
+                    << std::scientific << std::setprecision(4) << std::right << std::setw(11) << t_2_all.stddev()/1000.0
+                    << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_all.min()/1000.0
+                    << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_all.max()/1000.0
+                    << std::endl;
+#endif
 
                 file << "TIME PACK/POST:   "
                     << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_0.mean()/1000.0
@@ -514,6 +613,21 @@ namespace halo_exchange_3D_generic_full {
                 << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.min()/1000.0
                 << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.max()/1000.0
                 << std::endl;
+#ifdef GHEX_COMPRESSION_BENCHMARK
+            file << "COMPRESSION RATIO: "
+                << std::fixed << std::setprecision(3) << co.get_compression_statistics().ratio()
+                << std::endl;
+#endif
+#ifdef GHEX_COMPUTE_BENCHMARK
+            file << "TIME COMPUTE:     "
+                << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_local.mean()/1000.0
+                << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_global.mean()/1000.0
+                << " ±"
+                << std::scientific << std::setprecision(4) << std::right << std::setw(11) << t_2_global.stddev()/1000.0
+                << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_global.min()/1000.0
+                << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_2_global.max()/1000.0
+                << std::endl;
+#endif
             //file << std::endl << std::endl;
 
             MPI_Barrier(context.mpi_comm());
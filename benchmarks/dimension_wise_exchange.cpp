@@ -0,0 +1,135 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/structured/dimension_wise_exchange.hpp>
+#include <ghex/common/timer.hpp>
+
+using transport = gridtools::ghex::tl::mpi_tag;
+using factory = gridtools::ghex::tl::context_factory<transport>;
+using domain_descriptor_type = gridtools::ghex::structured::regular::domain_descriptor<int,3>;
+using halo_generator_type = gridtools::ghex::structured::regular::halo_generator<int,3>;
+using timer_type = gridtools::ghex::timer;
+
+// halo width and number of exchanges per measurement
+#ifndef GHEX_DIMENSION_WISE_BENCHMARK_HALO
+#define GHEX_DIMENSION_WISE_BENCHMARK_HALO 2
+#endif
+#ifndef GHEX_DIMENSION_WISE_BENCHMARK_REPS
+#define GHEX_DIMENSION_WISE_BENCHMARK_REPS 100
+#endif
+
+void print(int dim, const char* label, const timer_type& t_global, int rank)
+{
+    if (rank == 0)
+        std::cout << "DIM " << std::setw(6) << dim << "   " << label << " "
+            << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.mean()/1000.0
+            << " ±"
+            << std::scientific << std::setprecision(4) << std::right << std::setw(11) << t_global.stddev()/1000.0
+            << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.min()/1000.0
+            << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.max()/1000.0
+            << std::endl;
+}
+
+// time the exchange of one field on a periodic cube of D^3 points per rank, with all 26 neighbors at once and
+// dimension by dimension with the 6 face neighbors. Returns the speedup of the dimension-wise exchange.
+double run(int D, int num_reps)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const int size = context.size();
+    const int rank = context.rank();
+    const int H = GHEX_DIMENSION_WISE_BENCHMARK_HALO;
+    std::array<int,3> dims{0,0,0};
+    MPI_Dims_create(size, 3, dims.data());
+    const std::array<int,3> coords{rank%dims[0], (rank/dims[0])%dims[1], rank/(dims[0]*dims[1])};
+    const std::array<int,3> first{coords[0]*D, coords[1]*D, coords[2]*D};
+    std::vector<domain_descriptor_type> domains{domain_descriptor_type{rank, first,
+        std::array<int,3>{first[0]+D-1, first[1]+D-1, first[2]+D-1}}};
+    halo_generator_type hgen(std::array<int,3>{0,0,0},
+        std::array<int,3>{dims[0]*D-1, dims[1]*D-1, dims[2]*D-1}, std::array<int,6>{H,H,H,H,H,H},
+        std::array<bool,3>{true,true,true});
+    auto pattern = gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen, domains);
+
+    const std::array<int,3> extents{D+2*H, D+2*H, D+2*H};
+    std::vector<double> data(extents[0]*extents[1]*extents[2], rank);
+    auto field = gridtools::ghex::wrap_field<gridtools::ghex::cpu,2,1,0>(domains[0], data.data(),
+        std::array<int,3>{H,H,H}, extents);
+
+    auto co = gridtools::ghex::make_communication_object<decltype(pattern)>(context.get_communicator());
+    auto co_dw = gridtools::ghex::structured::make_dimension_wise_communication_object(pattern, hgen,
+        context.get_communicator());
+
+    // warm up
+    co.exchange(pattern(field)).wait();
+    co_dw.exchange(field);
+
+    timer_type t_local;
+    timer_type t_local_dw;
+    for (int k=0; k<num_reps; ++k)
+    {
+        MPI_Barrier(context.mpi_comm());
+        timer_type t;
+        t.tic();
+        co.exchange(pattern(field)).wait();
+        t.toc();
+        t_local(t);
+
+        MPI_Barrier(context.mpi_comm());
+        timer_type t_dw;
+        t_dw.tic();
+        co_dw.exchange(field);
+        t_dw.toc();
+        t_local_dw(t_dw);
+    }
+    const auto t_global = gridtools::ghex::reduce(t_local, context.mpi_comm());
+    const auto t_global_dw = gridtools::ghex::reduce(t_local_dw, context.mpi_comm());
+    print(D, "ALL NEIGHBORS TIME [ms]:  ", t_global, rank);
+    print(D, "DIMENSION-WISE TIME [ms]: ", t_global_dw, rank);
+    const double speedup = t_global.mean()/t_global_dw.mean();
+    if (rank == 0)
+        std::cout << "DIM " << std::setw(6) << D << "   DIMENSION-WISE SPEEDUP:    "
+            << std::fixed << std::setprecision(2) << std::right << std::setw(12) << speedup << std::endl;
+    return speedup;
+}
+
+TEST(dimension_wise_exchange, crossover)
+{
+    // the dimension-wise exchange sends fewer messages but needs three phases: it pays off where the exchange is
+    // latency bound. Report the first domain size at which the faster variant changes.
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    int crossover = 0;
+    bool dimension_wise_faster = false;
+    for (int D=4; D<=128; D*=2)
+    {
+        const bool faster = run(D, GHEX_DIMENSION_WISE_BENCHMARK_REPS) > 1.0;
+        if (D > 4 && faster != dimension_wise_faster && crossover == 0) crossover = D;
+        dimension_wise_faster = faster;
+    }
+    if (rank == 0)
+    {
+        if (crossover > 0)
+            std::cout << "CROSSOVER AT DIM " << crossover << std::endl;
+        else
+            std::cout << "NO CROSSOVER IN DIM 4 - 128" << std::endl;
+    }
+}
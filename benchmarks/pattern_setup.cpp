@@ -0,0 +1,125 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/structured/regular/cartesian_decomposition.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/common/timer.hpp>
+
+using transport = gridtools::ghex::tl::mpi_tag;
+using factory = gridtools::ghex::tl::context_factory<transport>;
+using domain_descriptor_type = gridtools::ghex::structured::regular::domain_descriptor<int,3>;
+using halo_generator_type = gridtools::ghex::structured::regular::halo_generator<int,3>;
+using decomposition_type = gridtools::ghex::structured::regular::cartesian_decomposition<3>;
+using timer_type = gridtools::ghex::timer;
+
+// number of domains per rank and their size
+#ifndef GHEX_SETUP_BENCHMARK_DOMAINS
+#define GHEX_SETUP_BENCHMARK_DOMAINS 2
+#endif
+#ifndef GHEX_SETUP_BENCHMARK_DIM
+#define GHEX_SETUP_BENCHMARK_DIM 32
+#endif
+
+void print(int num_ranks, const char* label, const timer_type& t_global, int rank)
+{
+    if (rank == 0)
+        std::cout << "RANKS " << std::setw(8) << num_ranks << "   " << label << " "
+            << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.mean()/1000.0
+            << " ±"
+            << std::scientific << std::setprecision(4) << std::right << std::setw(11) << t_global.stddev()/1000.0
+            << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.min()/1000.0
+            << std::scientific << std::setprecision(4) << std::right << std::setw(12) << t_global.max()/1000.0
+            << std::endl;
+}
+
+// time the construction of a structured pattern on the first num_ranks ranks of the world communicator, from the
+// list of domains and from a Cartesian decomposition
+void run(int num_ranks, int num_reps)
+{
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm comm;
+    MPI_Comm_split(MPI_COMM_WORLD, world_rank < num_ranks ? 0 : MPI_UNDEFINED, world_rank, &comm);
+    if (comm == MPI_COMM_NULL) return;
+    {
+        auto context_ptr = factory::create(comm);
+        auto& context = *context_ptr;
+        // 3D decomposition with GHEX_SETUP_BENCHMARK_DOMAINS domains per rank along the first dimension
+        const int D = GHEX_SETUP_BENCHMARK_DIM;
+        const int n = GHEX_SETUP_BENCHMARK_DOMAINS;
+        std::array<int,3> dims{0,0,0};
+        MPI_Dims_create(num_ranks, 3, dims.data());
+        const int rank = context.rank();
+        const std::array<int,3> coords{rank%dims[0], (rank/dims[0])%dims[1], rank/(dims[0]*dims[1])};
+        std::vector<domain_descriptor_type> domains;
+        for (int i=0; i<n; ++i)
+        {
+            const std::array<int,3> first{(coords[0]*n+i)*D, coords[1]*D, coords[2]*D};
+            domains.push_back(domain_descriptor_type{rank*n+i, first,
+                std::array<int,3>{first[0]+D-1, first[1]+D-1, first[2]+D-1}});
+        }
+        const std::array<int,3> g_first{0,0,0};
+        const std::array<int,3> g_last{dims[0]*n*D-1, dims[1]*D-1, dims[2]*D-1};
+        halo_generator_type hgen(g_first, g_last, std::array<int,6>{2,2,2,2,2,2}, std::array<bool,3>{true,true,true});
+
+        // the same decomposition described analytically
+        gridtools::ghex::hierarchical_decomposition<3> h_decomposition({1,1,1}, {1,1,1}, dims, {n,1,1});
+        decomposition_type::offsets_type offsets;
+        const std::array<int,3> num_domains{dims[0]*n, dims[1], dims[2]};
+        for (int d=0; d<3; ++d)
+            for (int i=0; i<=num_domains[d]; ++i) offsets[d].push_back(i*D);
+        const decomposition_type decomposition(comm, h_decomposition, offsets);
+
+        timer_type t_local;
+        timer_type t_local_cartesian;
+        for (int k=0; k<num_reps; ++k)
+        {
+            MPI_Barrier(comm);
+            timer_type t;
+            t.tic();
+            auto pattern = gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen, domains);
+            t.toc();
+            t_local(t);
+            EXPECT_EQ(pattern.size(), domains.size());
+
+            MPI_Barrier(comm);
+            timer_type t_cartesian;
+            t_cartesian.tic();
+            auto pattern_cartesian = gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen,
+                decomposition);
+            t_cartesian.toc();
+            t_local_cartesian(t_cartesian);
+            EXPECT_EQ(pattern_cartesian.size(), domains.size());
+        }
+        print(num_ranks, "SETUP TIME [ms]:          ", gridtools::ghex::reduce(t_local, comm), rank);
+        print(num_ranks, "CARTESIAN SETUP TIME [ms]:", gridtools::ghex::reduce(t_local_cartesian, comm), rank);
+    }
+    MPI_Comm_free(&comm);
+}
+
+TEST(pattern_setup, scaling)
+{
+    // pattern construction time for increasing numbers of ranks (powers of 2 and the world size)
+    int world_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    for (int num_ranks=1; num_ranks<world_size; num_ranks*=2)
+        run(num_ranks, 10);
+    run(world_size, 10);
+}
@@ -0,0 +1,57 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_COMMON_BFLOAT16_HPP
+#define INCLUDED_GHEX_COMMON_BFLOAT16_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace gridtools {
+
+    namespace ghex {
+
+        /** @brief 16 bit brain floating point number: the upper half of an IEEE single precision number
+          * (8 bit exponent, 7 bit mantissa). Conversion from float rounds to nearest even. */
+        class bfloat16
+        {
+        private: // members
+            std::uint16_t m_bits = 0;
+
+        public: // ctors
+            bfloat16() noexcept = default;
+            explicit bfloat16(float f) noexcept
+            {
+                std::uint32_t u;
+                std::memcpy(&u, &f, sizeof(u));
+                if ((u & 0x7fffffffu) > 0x7f800000u)
+                    // quiet NaN
+                    m_bits = static_cast<std::uint16_t>((u >> 16) | 0x0040u);
+                else
+                    m_bits = static_cast<std::uint16_t>((u + 0x7fffu + ((u >> 16) & 1u)) >> 16);
+            }
+
+        public: // member functions
+            operator float() const noexcept
+            {
+                const std::uint32_t u = static_cast<std::uint32_t>(m_bits) << 16;
+                float f;
+                std::memcpy(&f, &u, sizeof(f));
+                return f;
+            }
+
+            std::uint16_t bits() const noexcept { return m_bits; }
+        };
+
+    } // namespace ghex
+
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_COMMON_BFLOAT16_HPP */
@@ -0,0 +1,133 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_COMMON_STREAMING_STORES_HPP
+#define INCLUDED_GHEX_COMMON_STREAMING_STORES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/** @brief size in bytes of host buffers above which the pack kernels write with non-temporal stores */
+#ifndef GHEX_STREAMING_STORE_THRESHOLD
+#define GHEX_STREAMING_STORE_THRESHOLD 4194304
+#endif
+
+#if !defined(__CUDACC__) && (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define GHEX_STREAMING_STORES
+#include <emmintrin.h>
+#endif
+
+namespace gridtools {
+
+    namespace ghex {
+
+        /** @brief non-temporal (streaming) stores for large host buffers. Packing a buffer which is larger than
+          * the threshold bypasses the cache, such that the working set of the computation following the exchange
+          * is not evicted by data which is only read by the network. Unpacking such a buffer prefetches the
+          * received data ahead of the copy. The pack and unpack functions of the packers enable the streaming mode
+          * per buffer through a scope object. */
+        namespace streaming_stores {
+
+            /** @brief buffer size in bytes from which on streaming stores are used (initialized with
+              * GHEX_STREAMING_STORE_THRESHOLD). Set to 0 to always and to SIZE_MAX to never use them. */
+            inline std::size_t& threshold() noexcept
+            {
+                static std::size_t t = GHEX_STREAMING_STORE_THRESHOLD;
+                return t;
+            }
+
+            /** @brief true while the calling thread packs or unpacks a buffer in streaming mode */
+            inline bool& active() noexcept
+            {
+                static thread_local bool a = false;
+                return a;
+            }
+
+            /** @brief make the streaming stores of the calling thread globally visible */
+            inline void fence() noexcept
+            {
+#ifdef GHEX_STREAMING_STORES
+                _mm_sfence();
+#endif
+            }
+
+            /** @brief copy n bytes to dst without polluting the cache (regular copy if not supported)
+              * @param dst destination
+              * @param src source
+              * @param n number of bytes */
+            inline void copy(void* dst, const void* src, std::size_t n) noexcept
+            {
+                char* d = static_cast<char*>(dst);
+                const char* s = static_cast<const char*>(src);
+#ifdef GHEX_STREAMING_STORES
+                // the streamed part must be 16 byte aligned
+                const std::size_t head = (16u - (reinterpret_cast<std::uintptr_t>(d) & 15u)) & 15u;
+                if (n >= head+64u)
+                {
+                    std::memcpy(d, s, head);
+                    d += head; s += head; n -= head;
+                    for (; n >= 64u; n -= 64u, d += 64, s += 64)
+                    {
+                        __m128i* dv = reinterpret_cast<__m128i*>(d);
+                        const __m128i* sv = reinterpret_cast<const __m128i*>(s);
+                        _mm_stream_si128(dv+0, _mm_loadu_si128(sv+0));
+                        _mm_stream_si128(dv+1, _mm_loadu_si128(sv+1));
+                        _mm_stream_si128(dv+2, _mm_loadu_si128(sv+2));
+                        _mm_stream_si128(dv+3, _mm_loadu_si128(sv+3));
+                    }
+                }
+#endif
+                std::memcpy(d, s, n);
+            }
+
+            /** @brief hint that n bytes starting at p will be read once in the near future
+              * @param p address
+              * @param n number of bytes */
+            inline void prefetch(const void* p, std::size_t n) noexcept
+            {
+#if defined(__GNUC__) || defined(__clang__)
+                const char* c = static_cast<const char*>(p);
+                for (std::size_t i=0; i<n; i+=64) __builtin_prefetch(c+i, 0, 0);
+#else
+                (void)p; (void)n;
+#endif
+            }
+
+            /** @brief enables the streaming mode of the calling thread for the lifetime of the object (if the
+              * buffer is large enough) and fences the streaming stores on destruction. */
+            class scope
+            {
+            private: // members
+                bool m_previous;
+
+            public: // ctors
+                /** @param buffer_size size of the buffer in bytes */
+                scope(std::size_t buffer_size) noexcept
+                : m_previous{active()}
+                {
+                    active() = buffer_size >= threshold();
+                }
+                scope(const scope&) = delete;
+                scope& operator=(const scope&) = delete;
+                ~scope()
+                {
+                    if (active()) fence();
+                    active() = m_previous;
+                }
+            };
+
+        } // namespace streaming_stores
+
+    } // namespace ghex
+
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_COMMON_STREAMING_STORES_HPP */
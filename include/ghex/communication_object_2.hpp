@@ -17,10 +17,15 @@
 #include "./common/test_eq.hpp"
 #include "./buffer_info.hpp"
 #include "./transport_layer/tags.hpp"
+#include "./transport_layer/mpi/datatype.hpp"
+#include "./parallel_packer.hpp"
+#include "./compression.hpp"
 #include "./arch_traits.hpp"
+#include <algorithm>
 #include <map>
 #include <stdio.h>
 #include <functional>
+#include <memory>
 
 // Define this macro for fat callbacks
 // Description: Fat callbacks take advantage of the capability of the underlying communicator to
@@ -52,6 +57,123 @@ namespace gridtools {
             template<typename P, typename T, typename D, int... Order>
             struct is_regular_gpu<buffer_info<P,gpu,structured::regular::field_descriptor<T,gpu,D,Order...>>>
             : public std::true_type {};
+
+            template<typename...>
+            using void_t = void;
+
+            // traits class to check whether a communicator supports persistent requests
+            template<typename Communicator, typename = void>
+            struct has_persistent_requests : public std::false_type {};
+            template<typename Communicator>
+            struct has_persistent_requests<Communicator, void_t<typename Communicator::persistent_request_set_type>>
+            : public std::true_type {};
+
+            // returns the field memory of an iteration space if it is contiguous and laid out as in the buffer
+            template<typename Field, typename IndexContainer>
+            inline auto contiguous_ptr(Field* f, const IndexContainer& c, int)
+            -> decltype(f->contiguous_ptr(*c.begin()), (unsigned char*)nullptr)
+            {
+                if (c.size() != 1u) return nullptr;
+                return reinterpret_cast<unsigned char*>(f->contiguous_ptr(*c.begin()));
+            }
+            template<typename Field, typename IndexContainer>
+            inline unsigned char* contiguous_ptr(Field*, const IndexContainer&, long) { return nullptr; }
+
+            // returns a function which appends one MPI datatype per iteration space (empty if not supported by the field)
+            template<typename IndexContainer, typename Field>
+            inline auto datatype_function(Field* f, int)
+            -> decltype(f->mpi_datatype(*std::declval<const IndexContainer&>().begin()),
+                        std::function<void(const IndexContainer&, std::vector<MPI_Datatype>&)>())
+            {
+                return [f](const IndexContainer& c, std::vector<MPI_Datatype>& types)
+                {
+                    for (const auto& is : c) types.push_back(f->mpi_datatype(is));
+                };
+            }
+            template<typename IndexContainer, typename Field>
+            inline std::function<void(const IndexContainer&, std::vector<MPI_Datatype>&)> datatype_function(Field*, long)
+            {
+                return {};
+            }
+
+            // returns a function which copies iteration spaces of a field directly into another field of the same type
+            // (empty if not supported by the field)
+            template<typename IndexContainer, typename Field>
+            inline auto local_copy_function(Field* f, int)
+            -> decltype(f->copy_to(*f, *std::declval<const IndexContainer&>().begin(),
+                            *std::declval<const IndexContainer&>().begin()),
+                        std::function<void(void*, const IndexContainer&, const IndexContainer&)>())
+            {
+                return [f](void* dst, const IndexContainer& src_c, const IndexContainer& dst_c)
+                {
+                    auto dst_it = dst_c.begin();
+                    for (const auto& is : src_c) f->copy_to(*reinterpret_cast<Field*>(dst), is, *(dst_it++));
+                };
+            }
+            template<typename IndexContainer, typename Field>
+            inline std::function<void(void*, const IndexContainer&, const IndexContainer&)> local_copy_function(Field*, long)
+            {
+                return {};
+            }
+
+            // accessors to type-erased arrays of fields and buffers
+            template<typename Field>
+            struct fused_field_at
+            {
+                void* const* ptrs;
+                Field& operator()(std::size_t k) const noexcept { return *reinterpret_cast<Field*>(ptrs[k]); }
+            };
+            template<typename T>
+            struct fused_buffer_at
+            {
+                void* const* ptrs;
+                T* operator()(std::size_t k) const noexcept { return reinterpret_cast<T*>(ptrs[k]); }
+            };
+
+            template<typename IndexContainer>
+            using fused_function_t = void(*)(void* const*, void* const*, std::size_t, const IndexContainer&);
+
+            // returns a function which packs (unpacks) several host fields of the same type in one traversal
+            // (nullptr if not supported by the field)
+            template<typename IndexContainer, typename Field>
+            inline auto fused_function(Field*, bool receive, int)
+            -> decltype(Field::pack_fused(std::size_t{}, fused_field_at<Field>{},
+                            fused_buffer_at<typename Field::value_type>{}, std::declval<const IndexContainer&>()),
+                        Field::unpack_fused(std::size_t{}, fused_field_at<Field>{},
+                            fused_buffer_at<const typename Field::value_type>{}, std::declval<const IndexContainer&>()),
+                        std::enable_if_t<std::is_same<typename Field::arch_type, cpu>::value,
+                            fused_function_t<IndexContainer>>())
+            {
+                using T = typename Field::value_type;
+                if (receive)
+                    return [](void* const* fields, void* const* buffers, std::size_t n, const IndexContainer& c)
+                    {
+                        Field::unpack_fused(n, fused_field_at<Field>{fields}, fused_buffer_at<const T>{buffers}, c);
+                    };
+                return [](void* const* fields, void* const* buffers, std::size_t n, const IndexContainer& c)
+                {
+                    Field::pack_fused(n, fused_field_at<Field>{fields}, fused_buffer_at<T>{buffers}, c);
+                };
+            }
+            template<typename IndexContainer, typename Field>
+            inline fused_function_t<IndexContainer> fused_function(Field*, bool, long)
+            {
+                return nullptr;
+            }
+
+            // unique address per type
+            template<typename T>
+            inline const void* type_tag() noexcept
+            {
+                static const char tag = 0;
+                return &tag;
+            }
+
+            // address which identifies the memory of a field
+            template<typename Field>
+            inline auto memory_address(Field& f, int) -> decltype((const void*)f.data()) { return f.data(); }
+            template<typename Field>
+            inline const void* memory_address(Field& f, long) { return &f; }
         } // namespace detail
 
         // forward declaration
@@ -62,6 +184,8 @@ namespace gridtools {
         // forward declaration
         template<typename Communicator, typename GridType, typename DomainIdType>
         class communication_object;
+        template<typename Communicator, typename GridType, typename DomainIdType>
+        class exchange_plan;
 
         /** @brief handle type for waiting on asynchronous communication processes.
           * The wait function is stored in a member.
@@ -82,6 +206,7 @@ namespace gridtools {
         private: // members
             communicator_type m_comm;
             std::function<void()> m_wait_fct;
+            std::function<bool()> m_test_fct;
 
         public: // public constructor
             /** @brief construct a ready handle
@@ -98,6 +223,16 @@ namespace gridtools {
             communication_handle(const communicator_type& comm, Func&& wait_fct) 
             : m_comm{comm}, m_wait_fct(std::forward<Func>(wait_fct)) {}
 
+            /** @brief construct a handle with a wait and a test function
+              * @tparam Func function type with signature void()
+              * @tparam TestFunc function type with signature bool()
+              * @param comm communicator
+              * @param wait_fct wait function
+              * @param test_fct test function */
+            template<typename Func, typename TestFunc>
+            communication_handle(const communicator_type& comm, Func&& wait_fct, TestFunc&& test_fct)
+            : m_comm{comm}, m_wait_fct(std::forward<Func>(wait_fct)), m_test_fct(std::forward<TestFunc>(test_fct)) {}
+
         public: // copy and move ctors
             communication_handle(communication_handle&&) = default;
             communication_handle(const communication_handle&) = delete;
@@ -108,6 +243,14 @@ namespace gridtools {
             /** @brief  wait for communication to be finished*/
             void wait() { if (m_wait_fct) m_wait_fct(); }
             void progress() { m_comm.progress(); }
+
+            /** @brief check for completion without blocking. Data which has arrived is unpacked, and the exchange
+              * is finished (as by wait) once all messages have been transferred.
+              * @return true if the communication has finished */
+            bool test() { return m_test_fct ? m_test_fct() : !m_wait_fct; }
+
+            /** @brief same as test */
+            bool ready() { return test(); }
         };
 
      
@@ -131,8 +274,23 @@ namespace gridtools {
             template<typename D, typename F>
             using buffer_info_type        = buffer_info<pattern_type,D,F>;
 
+            /** @brief plan type returned by make_exchange_plan */
+            using plan_type               = exchange_plan<Communicator,GridType,DomainIdType>;
+
+            /** @brief callback type invoked per neighbor with the local and the remote domain id */
+            using neighbor_callback_type  = std::function<void(domain_id_type, domain_id_type)>;
+
+            /** @brief amount of data sent through compressed messages */
+            struct compression_statistics
+            {
+                std::size_t raw_bytes = 0;
+                std::size_t message_bytes = 0;
+                double ratio() const noexcept { return message_bytes ? (double)raw_bytes/message_bytes : 1.0; }
+            };
+
         private: // friend class
             friend class communication_handle<Communicator,GridType,DomainIdType>;
+            friend class exchange_plan<Communicator,GridType,DomainIdType>;
             template<template <typename> class RangeGen, typename Pattern, typename... Fields>
             friend class bulk_communication_object;
 
@@ -160,19 +318,37 @@ namespace gridtools {
             /** @brief Holds a pointer to a set of iteration spaces and a callback function pointer 
               * which is used to store a field's pack or unpack member function. 
               * This class also stores the offset in the serialized buffer in bytes.
-              * The type-erased field_ptr member is only used for the gpu-vector-interface.
+              * The type-erased field_ptr member is used by the gpu-vector-interface and by the fused host packing.
               * @tparam Function Either pack or unpack function pointer type */
             template<typename Function>
             struct field_info
             {
                 using index_container_type = typename pattern_type::map_type::mapped_type;
+                using datatype_function_type =
+                    std::function<void(const index_container_type&, std::vector<MPI_Datatype>&)>;
+                using local_copy_function_type =
+                    std::function<void(void*, const index_container_type&, const index_container_type&)>;
                 Function call_back;
                 const index_container_type* index_container;
                 std::size_t offset;
                 void* field_ptr;
+                datatype_function_type make_datatypes = {};
+                std::size_t element_size = 0;
+                local_copy_function_type local_copy = {};
+                const void* field_type = nullptr;
+                detail::fused_function_t<index_container_type> fused = nullptr;
+            };
+
+            /** @brief field to field copies which replace the messages between two domains on the same rank */
+            struct local_copy
+            {
+                domain_id_pair domain_ids;
+                std::vector<std::function<void()>> copies;
             };
 
-            /** @brief Holds serial buffer memory and meta information associated with it
+            /** @brief Holds serial buffer memory and meta information associated with it. If the buffer consists
+              * of a single contiguous region of field memory, zero_copy_ptr points to it and the data is sent
+              * or received directly without using the buffer.
               * @tparam Vector contiguous buffer memory type
               * @tparam Function Either pack or unpack function pointer type */
             template<class Vector, class Function>
@@ -185,6 +361,10 @@ namespace gridtools {
                 std::size_t size;
                 std::vector<field_info_type> field_infos;
                 cuda::stream m_cuda_stream;
+                unsigned char* zero_copy_ptr = nullptr;
+                domain_id_pair domain_ids = {};
+                const compression::codec* codec = nullptr;
+                std::vector<unsigned char> compressed = {};
             };
 
             /** @brief Holds maps of buffers for send and recieve operations indexed by a domain_id_pair and a device id
@@ -201,7 +381,9 @@ namespace gridtools {
                 using send_memory_type = std::map<device_id_type, std::map<domain_id_pair,send_buffer_type>>;
                 using recv_memory_type = std::map<device_id_type, std::map<domain_id_pair,recv_buffer_type>>;
 
-                std::map<device_id_type, std::unique_ptr<typename arch_traits<Arch>::pool_type>> m_pools;
+                // memory pools (shared among the exchange epochs of a communication object)
+                using pools_type       = std::map<device_id_type, std::unique_ptr<typename arch_traits<Arch>::pool_type>>;
+                std::shared_ptr<pools_type> m_pools = std::make_shared<pools_type>();
                 send_memory_type send_memory;
                 recv_memory_type recv_memory;
 
@@ -219,22 +401,288 @@ namespace gridtools {
             template<typename T, typename R>
             using disable_if_buffer_info = std::enable_if_t< !is_buffer_info<T>::value, R>;
 
+            /** @brief persistent send and receive requests for the cpu buffers of an exchange plan (no-op if the
+              * communicator does not support persistent requests) */
+            template<bool HasPersistentRequests, typename Dummy = void>
+            struct persistent_requests
+            {
+                bool enabled() const noexcept { return false; }
+                template<typename Memory>
+                void init(communicator_type&, Memory&) {}
+                void start() {}
+                template<typename Continuation>
+                void wait(Continuation&&) {}
+                template<typename Continuation>
+                bool test(Continuation&&) { return true; }
+            };
+
+            template<typename Dummy>
+            struct persistent_requests<true, Dummy>
+            {
+                using request_set_type = typename communicator_type::persistent_request_set_type;
+                using send_hook_type   = typename buffer_memory<cpu>::send_buffer_type*;
+                using recv_hook_type   = typename buffer_memory<cpu>::recv_buffer_type*;
+
+                request_set_type m_send_reqs;
+                request_set_type m_recv_reqs;
+                std::vector<send_hook_type> m_send_hooks;
+                std::vector<recv_hook_type> m_recv_hooks;
+
+                bool enabled() const noexcept { return !(m_send_reqs.empty() && m_recv_reqs.empty()); }
+
+                // create one persistent request per non-empty buffer
+                template<typename Memory>
+                void init(communicator_type& comm, Memory& m)
+                {
+                    for (auto& p0 : m.recv_memory)
+                        for (auto& p1: p0.second)
+                            if (p1.second.size > 0u)
+                            {
+                                if (p1.second.zero_copy_ptr)
+                                {
+                                    tl::cb::ref_message<unsigned char> msg{p1.second.zero_copy_ptr, p1.second.size};
+                                    m_recv_reqs.push_back(comm.recv_init(msg, p1.second.address, p1.second.tag));
+                                }
+                                else
+                                    m_recv_reqs.push_back(comm.recv_init(p1.second.buffer, p1.second.address, p1.second.tag));
+                                m_recv_hooks.push_back(&p1.second);
+                            }
+                    for (auto& p0 : m.send_memory)
+                        for (auto& p1: p0.second)
+                            if (p1.second.size > 0u)
+                            {
+                                if (p1.second.zero_copy_ptr)
+                                {
+                                    const tl::cb::ref_message<unsigned char> msg{p1.second.zero_copy_ptr, p1.second.size};
+                                    m_send_reqs.push_back(comm.send_init(msg, p1.second.address, p1.second.tag));
+                                }
+                                else
+                                {
+                                    m_send_reqs.push_back(comm.send_init(p1.second.buffer, p1.second.address, p1.second.tag));
+                                    m_send_hooks.push_back(&p1.second);
+                                }
+                            }
+                }
+
+                // post receives, pack and send
+                void start()
+                {
+                    m_recv_reqs.start_all();
+                    for (auto ptr : m_send_hooks)
+                    {
+                        // large buffers are written with non-temporal stores
+                        const streaming_stores::scope s(ptr->size);
+                        detail::for_each_field(ptr->field_infos, ptr->buffer.data());
+                    }
+                    m_send_reqs.start_all();
+                }
+
+                // unpack as messages arrive and wait for sends to finish
+                template<typename Continuation>
+                void wait(Continuation&& cont)
+                {
+                    while (m_recv_reqs.num_active() > 0)
+                        m_recv_reqs.wait_some([this,&cont](std::size_t i)
+                        {
+                            packer<cpu>::unpack(*m_recv_hooks[i], m_recv_hooks[i]->buffer.data());
+                            cont(*m_recv_hooks[i]);
+                        });
+                    m_send_reqs.wait_all();
+                }
+
+                // unpack the messages which have arrived, returns true if all requests have completed
+                template<typename Continuation>
+                bool test(Continuation&& cont)
+                {
+                    const bool recvs_done = m_recv_reqs.test_some([this,&cont](std::size_t i)
+                        {
+                            packer<cpu>::unpack(*m_recv_hooks[i], m_recv_hooks[i]->buffer.data());
+                            cont(*m_recv_hooks[i]);
+                        });
+                    return recvs_done && m_send_reqs.test_all();
+                }
+            };
+
+            using persistent_requests_type = persistent_requests<detail::has_persistent_requests<communicator_type>::value>;
+
+            /** @brief a message described by an MPI datatype spanning all fields exchanged with one neighbor */
+            struct datatype_message
+            {
+                address_type address;
+                int tag;
+                tl::mpi::datatype type;
+            };
+
+            /** @brief committed datatypes for a particular set of patterns and fields */
+            struct datatype_exchange
+            {
+                std::vector<datatype_message> send_messages;
+                std::vector<datatype_message> recv_messages;
+            };
+
+            using datatype_cache_type = std::map<std::vector<const void*>, datatype_exchange>;
+
         private: // members
             bool m_valid;
+            bool m_planned = false;
+            bool m_use_persistent_requests = true;
+            bool m_use_mpi_datatypes = false;
+            bool m_parallel_packing = false;
+            int m_num_pack_threads = 0;
+            neighbor_callback_type m_neighbor_callback;
+            bool m_compression = false;
+            std::size_t m_compression_threshold = 0;
+            compression_statistics m_compression_stats;
+            int m_num_epochs = 1;
+            int m_epoch = 0;
+            std::size_t m_next_epoch = 0;
+            std::vector<std::unique_ptr<communication_object>> m_epochs;
+            std::vector<local_copy> m_local_copies;
+            std::size_t m_num_send_buffers = 0;
             communicator_type m_comm;
             memory_type m_mem;
+            persistent_requests_type m_persistent_requests;
+            datatype_cache_type m_datatype_cache;
+            datatype_exchange* m_datatypes = nullptr;
             std::vector<future_type> m_send_futures;
+            std::vector<future_type> m_datatype_futures; // receives and sends of the MPI datatype exchange
 #ifdef GHEX_COMM_OBJ_USE_FAT_CALLBACKS
             std::vector<request_cb_type> m_recv_reqs;
 #endif
 
         public: // ctors
             communication_object(communicator_type comm) : m_valid(false) , m_comm(comm) {}
+
+            /** @brief construct a communication object which allows for several exchanges in flight at the same
+              * time. Exchanges are assigned to epochs in round-robin order, where each epoch uses its own tag range
+              * and buffers, while the memory pools are shared. Hence, the order of exchanges must be the same on all
+              * ranks, and an exchange must be finished before its epoch is reused.
+              * @param comm communicator
+              * @param num_epochs number of exchanges which may be in flight concurrently */
+            communication_object(communicator_type comm, int num_epochs)
+            : m_valid(false) , m_comm(comm)
+            {
+                if (num_epochs < 1)
+                    throw std::runtime_error("number of exchange epochs must be positive");
+                if (num_epochs == 1) return;
+                for (int e=0; e<num_epochs; ++e)
+                {
+                    m_epochs.emplace_back(new communication_object(comm));
+                    m_epochs.back()->m_num_epochs = num_epochs;
+                    m_epochs.back()->m_epoch = e;
+                    // share the memory pools
+                    auto& epoch_mem = m_epochs.back()->m_mem;
+                    detail::for_each(m_mem, [&epoch_mem](auto& m)
+                    {
+                        std::get<std::remove_reference_t<decltype(m)>>(epoch_mem).m_pools = m.m_pools;
+                    });
+                }
+            }
+
             communication_object(const communication_object&) = delete;
             communication_object(communication_object&&) = default;
 
             communicator_type communicator() const { return m_comm; }
 
+            /** @brief choose whether exchange plans created by this object use persistent requests (if supported
+              * by the communicator). Persistent requests are set up once per plan and restarted for every exchange.
+              * @param enable use persistent requests if true (default) */
+            void use_persistent_requests(bool enable) noexcept { m_use_persistent_requests = enable; }
+
+            /** @brief choose whether halos are exchanged through MPI derived datatypes instead of packing into
+              * buffers. The datatypes span all fields exchanged with a neighbor, such that one message is sent per
+              * neighbor directly from field memory. They are built on first use and cached per set of patterns and
+              * field memory. Requires host fields which provide an mpi_datatype member function and an MPI
+              * communicator. Must be chosen consistently on all ranks.
+              * @param enable use MPI datatypes if true (default: false) */
+            void use_mpi_datatypes(bool enable) noexcept { m_use_mpi_datatypes = enable; }
+
+            /** @brief choose whether host buffers are packed and unpacked by a team of OpenMP threads. The work is
+              * split by neighbor, field and iteration space. Each buffer is sent as soon as it is packed, and received
+              * buffers are unpacked in parallel as they arrive. Sends are posted from within the thread team, which
+              * requires a transport layer that allows this (e.g. MPI initialized with MPI_THREAD_SERIALIZED or
+              * higher). Exchange plans created with parallel packing do not use persistent requests.
+              * @param enable use parallel packing if true (default: false)
+              * @param num_threads number of threads (0: OpenMP default) */
+            void use_parallel_packing(bool enable, int num_threads = 0) noexcept
+            {
+                m_parallel_packing = enable;
+                m_num_pack_threads = num_threads;
+            }
+
+            /** @brief register a function which is called as soon as the halo data a local domain receives from a
+              * neighboring domain is in place (i.e. after unpacking), with the local and the remote domain id as
+              * arguments. The function is invoked from within wait() or test() of the handle, or from one of the
+              * packing threads (one at a time) when parallel packing is enabled. It is not invoked for exchanges
+              * through MPI datatypes.
+              * @param cb callback (an empty function disables the notification) */
+            void set_neighbor_callback(neighbor_callback_type cb) { m_neighbor_callback = std::move(cb); }
+
+            /** @brief choose whether host messages are compressed. The codec is selected per field type through
+              * compression::codec_traits and is applied to each neighbor buffer which holds at least threshold
+              * bytes. Compressed buffers are neither sent nor received in place, and exchange plans do not use
+              * persistent requests. Must be chosen consistently on all ranks. It has no effect on exchanges
+              * through MPI datatypes.
+              * @param enable compress messages if true (default: false)
+              * @param threshold minimum uncompressed message size in bytes */
+            void use_compression(bool enable, std::size_t threshold = 4096) noexcept
+            {
+                m_compression = enable;
+                m_compression_threshold = threshold;
+            }
+
+            /** @brief statistics of the messages compressed by this object (and its epochs) so far */
+            compression_statistics get_compression_statistics() const noexcept
+            {
+                auto res = m_compression_stats;
+                for (const auto& e : m_epochs)
+                {
+                    const auto r = e->get_compression_statistics();
+                    res.raw_bytes += r.raw_bytes;
+                    res.message_bytes += r.message_bytes;
+                }
+                return res;
+            }
+
+            /** @brief free all cached MPI datatypes (e.g. when field memory was reallocated) */
+            void clear_datatype_cache()
+            {
+                if (m_valid && m_datatypes)
+                    throw std::runtime_error("earlier exchange operation was not finished");
+                m_datatype_cache.clear();
+                for (auto& e : m_epochs) e->clear_datatype_cache();
+            }
+
+            /** @brief discard the buffer setup of previous exchanges, e.g. after the patterns were updated: the
+              * neighbor buffers, cached MPI datatypes and persistent requests are released, while the memory pools
+              * are kept, such that the buffers of the next exchange are served from the pooled memory */
+            void refresh()
+            {
+                if (m_valid)
+                    throw std::runtime_error("earlier exchange operation was not finished");
+                m_planned = false;
+                m_persistent_requests = persistent_requests_type{};
+                m_datatype_cache.clear();
+                m_datatypes = nullptr;
+                m_local_copies.clear();
+                detail::for_each(m_mem, [](auto& m)
+                {
+                    m.send_memory.clear();
+                    m.recv_memory.clear();
+                });
+                for (auto& e : m_epochs) e->refresh();
+            }
+
+            /** @brief number of exchanges which may be in flight concurrently */
+            int num_epochs() const noexcept { return m_epochs.empty() ? 1 : static_cast<int>(m_epochs.size()); }
+
+            /** @brief number of domain pairs whose halos were copied field to field by the last exchange, since
+              * both domains reside on this rank */
+            std::size_t num_local_copies() const noexcept { return m_local_copies.size(); }
+
+            /** @brief number of non-empty send buffers set up by the last exchange (same-rank local copies excluded) */
+            std::size_t num_send_buffers() const noexcept { return m_num_send_buffers; }
+
         public: // exchange arbitrary field-device-pattern combinations
             /** @brief blocking variant of halo exchange
               * @tparam Archs list of device types
@@ -254,10 +702,13 @@ namespace gridtools {
             template<typename... Archs, typename... Fields>
             [[nodiscard]] handle_type exchange(buffer_info_type<Archs,Fields>... buffer_infos)
             {
+                if (!m_epochs.empty()) return next_epoch().exchange(buffer_infos...);
+                if (m_use_mpi_datatypes) return exchange_datatypes(buffer_infos...);
                 exchange_impl(buffer_infos...);
-                handle_type h(m_comm, [this](){this->wait();});
+                handle_type h(m_comm, [this](){this->wait();}, [this](){return this->test();});
                 post_recvs();
                 pack();
+                copy_local();
                 return h; 
             }
 
@@ -270,6 +721,7 @@ namespace gridtools {
             [[nodiscard]] disable_if_buffer_info<Iterator,handle_type>
             exchange(Iterator first, Iterator last)
             {
+                if (!m_epochs.empty()) return next_epoch().exchange(first, last);
                 // call special function for a single range
                 return exchange_u(first, last); 
             }
@@ -289,12 +741,126 @@ namespace gridtools {
             exchange(Iterator0 first0, Iterator0 last0, Iterator1 first1, Iterator1 last1, Iterators... iters)
             {
                 static_assert(sizeof...(Iterators) % 2 == 0, "need even number of iteratiors: (begin,end) pairs");
+                if (!m_epochs.empty()) return next_epoch().exchange(first0, last0, first1, last1, iters...);
                 // call helper function to turn iterators into pairs of iterators
                 return exchange_make_pairs(std::make_index_sequence<2+sizeof...(iters)/2>(),
                     first0, last0, first1, last1, iters...); 
             }
 
+            /** @brief set up all communication buffers for a fixed set of fields once and return a plan which
+              * can be used to exchange these fields repeatedly. Tag offsets, buffer sizes and pack/unpack
+              * callbacks are computed here; the exchange function of the plan only posts receives, packs and
+              * sends. Attention: the plan holds references to the fields and patterns!
+              * @tparam Archs list of device types
+              * @tparam Fields list of field types
+              * @param buffer_infos buffer_info objects created by binding a field descriptor to a pattern
+              * @return exchange plan */
+            template<typename... Archs, typename... Fields>
+            plan_type make_exchange_plan(buffer_info_type<Archs,Fields>... buffer_infos) const
+            {
+                std::unique_ptr<this_type> co(new this_type(m_comm));
+                copy_settings(*co);
+                co->exchange_impl(buffer_infos...);
+                co->make_persistent();
+                return plan_type(std::move(co));
+            }
+
         private: // implementation
+            // pass the current settings on to another communication object
+            void copy_settings(this_type& co) const
+            {
+                co.m_use_persistent_requests = m_use_persistent_requests;
+                co.m_use_mpi_datatypes = m_use_mpi_datatypes;
+                co.m_parallel_packing = m_parallel_packing;
+                co.m_num_pack_threads = m_num_pack_threads;
+                co.m_neighbor_callback = m_neighbor_callback;
+                co.m_compression = m_compression;
+                co.m_compression_threshold = m_compression_threshold;
+            }
+
+            // select the epoch for the next exchange (round robin)
+            this_type& next_epoch()
+            {
+                auto& co = *m_epochs[m_next_epoch];
+                if (co.m_valid)
+                    throw std::runtime_error("earlier exchange operation of this epoch was not finished");
+                m_next_epoch = (m_next_epoch+1) % m_epochs.size();
+                copy_settings(co);
+                return co;
+            }
+
+            // exchange through cached MPI datatypes
+            template<typename... Archs, typename... Fields>
+            handle_type exchange_datatypes(buffer_info_type<Archs,Fields>... buffer_infos)
+            {
+                if (m_valid)
+                    throw std::runtime_error("earlier exchange operation was not finished");
+                std::vector<const void*> key{
+                    static_cast<const void*>(&buffer_infos.get_pattern())...,
+                    detail::memory_address(buffer_infos.get_field(), 0)...};
+                auto it = m_datatype_cache.find(key);
+                if (it == m_datatype_cache.end())
+                {
+                    // compute neighbors, tags and iteration spaces through the regular buffer setup
+                    exchange_impl(buffer_infos...);
+                    it = m_datatype_cache.insert(std::make_pair(std::move(key), make_datatypes())).first;
+                    clear();
+                }
+                m_valid = true;
+                m_datatypes = &(it->second);
+                handle_type h(m_comm, [this](){this->wait();}, [this](){return this->test();});
+                post_datatypes(m_comm, 0);
+                return h;
+            }
+
+            // build one datatype per neighbor from the current buffer setup
+            datatype_exchange make_datatypes()
+            {
+                datatype_exchange res;
+                detail::for_each(m_mem, [&res](auto& m)
+                {
+                    using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
+                    auto make = [](auto& memory, std::vector<datatype_message>& messages)
+                    {
+                        std::vector<MPI_Datatype> types;
+                        for (auto& p0 : memory)
+                            for (auto& p1 : p0.second)
+                            {
+                                if (p1.second.size == 0u) continue;
+                                if (!std::is_same<arch_type,cpu>::value)
+                                    throw std::runtime_error("MPI datatype exchange requires host fields");
+                                for (const auto& fb : p1.second.field_infos)
+                                {
+                                    if (!fb.make_datatypes)
+                                        throw std::runtime_error("field type does not support MPI datatypes");
+                                    fb.make_datatypes(*fb.index_container, types);
+                                }
+                                messages.push_back(datatype_message{p1.second.address, p1.second.tag,
+                                    tl::mpi::datatype(types)});
+                            }
+                    };
+                    make(m.recv_memory, res.recv_messages);
+                    make(m.send_memory, res.send_messages);
+                });
+                return res;
+            }
+
+            // post receives and sends for the current datatypes
+            template<typename Comm>
+            auto post_datatypes(Comm& comm, int)
+            -> decltype(comm.send_datatype(std::declval<const tl::mpi::datatype&>(), 0, 0), void())
+            {
+                for (const auto& msg : m_datatypes->recv_messages)
+                    m_datatype_futures.push_back(comm.recv_datatype(msg.type, msg.address, msg.tag));
+                for (const auto& msg : m_datatypes->send_messages)
+                    m_datatype_futures.push_back(comm.send_datatype(msg.type, msg.address, msg.tag));
+            }
+            template<typename Comm>
+            void post_datatypes(Comm&, long)
+            {
+                throw std::runtime_error("communicator does not support MPI datatypes");
+            }
+
             // overload for pairs of iterators
             template<typename... Iterators>
             [[nodiscard]]
@@ -303,7 +869,8 @@ namespace gridtools {
                 exchange_impl(iter_pairs...);
                 post_recvs();
                 pack();
-                return handle_type(m_comm, [this](){this->wait();});
+                copy_local();
+                return handle_type(m_comm, [this](){this->wait();}, [this](){return this->test();});
             }
             
             // helper function to turn iterators into pairs of iterators
@@ -365,7 +932,7 @@ namespace gridtools {
                 // pack
                 packer<gpu>::template pack_u<value_type, field_type>(gpu_mem,m_send_futures,m_comm);
                 // return handle
-                return handle_type(m_comm, [this](){this->wait();});
+                return handle_type(m_comm, [this](){this->wait();}, [this](){return this->test();});
 #else
                 for (auto& p0 : gpu_mem.recv_memory)
                 {
@@ -384,7 +951,9 @@ namespace gridtools {
                 // pack
                 packer<gpu>::template pack_u<value_type, field_type>(gpu_mem,m_send_futures,m_comm);
                 // return handle
-                return handle_type(m_comm, [this](){this->template wait_u_gpu<field_type>();});
+                // no partial progress on this path: test completes the exchange
+                return handle_type(m_comm, [this](){this->template wait_u_gpu<field_type>();},
+                    [this](){this->template wait_u_gpu<field_type>(); return true;});
 #endif
             }
 #endif
@@ -424,6 +993,9 @@ namespace gridtools {
                             it->device_id(), tag_offset);
                     }
                 });
+                if (!m_use_mpi_datatypes) setup_local_copies();
+                setup_compression();
+                count_send_buffers();
             }
 
             // helper function to set up communicaton buffers (compile-time case)
@@ -467,6 +1039,90 @@ namespace gridtools {
                     allocate<arch_type,value_type>(mem, bi->get_pattern(), field_ptr, my_dom_id, bi->device_id(), tag_offsets[i]);
                     ++i;
                 });
+                if (!m_use_mpi_datatypes) setup_local_copies();
+                setup_compression();
+                count_send_buffers();
+            }
+
+            // replace the messages between two domains which are both part of this exchange and reside on this
+            // rank by field to field copies: the corresponding send and receive buffers are emptied
+            void setup_local_copies()
+            {
+                m_local_copies.clear();
+                auto& m = std::get<buffer_memory<cpu>>(m_mem);
+                for (auto& p0 : m.send_memory)
+                {
+                    auto r_it = m.recv_memory.find(p0.first);
+                    if (r_it == m.recv_memory.end()) continue;
+                    for (auto& p1 : p0.second)
+                    {
+                        auto& sb = p1.second;
+                        if (sb.size == 0u || sb.address != m_comm.address()) continue;
+                        // the receive buffer of the neighbor has the same key
+                        auto it = r_it->second.find(p1.first);
+                        if (it == r_it->second.end()) continue;
+                        auto& rb = it->second;
+                        if (rb.size != sb.size || rb.field_infos.size() != sb.field_infos.size()) continue;
+                        bool supported = true;
+                        for (std::size_t i=0; i<sb.field_infos.size(); ++i)
+                            supported = supported && sb.field_infos[i].local_copy &&
+                                (sb.field_infos[i].field_type == rb.field_infos[i].field_type);
+                        if (!supported) continue;
+                        local_copy lc{rb.domain_ids, {}};
+                        for (std::size_t i=0; i<sb.field_infos.size(); ++i)
+                        {
+                            const auto& s_fi = sb.field_infos[i];
+                            const auto& r_fi = rb.field_infos[i];
+                            lc.copies.push_back([copy = s_fi.local_copy, dst = r_fi.field_ptr,
+                                src_c = s_fi.index_container, dst_c = r_fi.index_container]()
+                                { copy(dst, *src_c, *dst_c); });
+                        }
+                        m_local_copies.push_back(std::move(lc));
+                        sb.size = 0u;
+                        rb.size = 0u;
+                    }
+                }
+            }
+
+            // count the non-empty send buffers (the sizes are reset after each exchange)
+            void count_send_buffers()
+            {
+                m_num_send_buffers = 0;
+                detail::for_each(m_mem, [this](auto& m)
+                {
+                    for (const auto& p0 : m.send_memory)
+                        for (const auto& p1 : p0.second)
+                            if (p1.second.size > 0u) ++m_num_send_buffers;
+                });
+            }
+
+            // keep the codecs of host buffers above the size threshold only
+            void setup_compression()
+            {
+                if (!m_compression) return;
+                auto& m = std::get<buffer_memory<cpu>>(m_mem);
+                auto setup = [this](auto& memory)
+                {
+                    for (auto& p0 : memory)
+                        for (auto& p1 : p0.second)
+                        {
+                            auto& b = p1.second;
+                            if (b.size < m_compression_threshold) b.codec = nullptr;
+                            if (b.codec) b.zero_copy_ptr = nullptr;
+                        }
+                };
+                setup(m.send_memory);
+                setup(m.recv_memory);
+            }
+
+            // perform the field to field copies for same-rank neighbors
+            void copy_local()
+            {
+                for (const auto& lc : m_local_copies)
+                {
+                    for (const auto& c : lc.copies) c();
+                    notify(lc);
+                }
             }
 
             void post_recvs()
@@ -481,17 +1137,35 @@ namespace gridtools {
                         {
                             if (p1.second.size > 0u)
                             {
-                                p1.second.buffer.resize(p1.second.size);
                                 auto ptr = &p1.second;
-                                // use callbacks for unpacking
-                                m_recv_reqs.push_back(
-                                    m_comm.recv(p1.second.buffer, p1.second.address, p1.second.tag,
-                                    [ptr](typename communicator_type::message_type m, 
+                                auto cb = [this,ptr](typename communicator_type::message_type m,
                                        typename communicator_type::rank_type,
                                        typename communicator_type::tag_type)
                                     {
                                         packer<arch_type>::unpack(*ptr, m.data());
-                                    }));
+                                        if (std::is_same<arch_type,cpu>::value) this->notify(*ptr);
+                                    };
+                                // receive the encoded message
+                                if (p1.second.codec)
+                                {
+                                    p1.second.compressed.resize(compression::max_message_size(p1.second.size));
+                                    m_recv_reqs.push_back(
+                                        m_comm.recv(tl::cb::ref_message<unsigned char>{p1.second.compressed.data(),
+                                        p1.second.compressed.size()}, p1.second.address, p1.second.tag, cb));
+                                    continue;
+                                }
+                                // receive directly into field memory if possible
+                                if (p1.second.zero_copy_ptr)
+                                {
+                                    m_recv_reqs.push_back(
+                                        m_comm.recv(tl::cb::ref_message<unsigned char>{p1.second.zero_copy_ptr, p1.second.size},
+                                        p1.second.address, p1.second.tag, cb));
+                                    continue;
+                                }
+                                p1.second.buffer.resize(p1.second.size);
+                                // use callbacks for unpacking
+                                m_recv_reqs.push_back(
+                                    m_comm.recv(p1.second.buffer, p1.second.address, p1.second.tag, cb));
                             }
                         }
                     }
@@ -505,6 +1179,28 @@ namespace gridtools {
                         {
                             if (p1.second.size > 0u)
                             {
+                                // receive the encoded message
+                                if (p1.second.codec)
+                                {
+                                    p1.second.compressed.resize(compression::max_message_size(p1.second.size));
+                                    tl::cb::ref_message<unsigned char> msg{p1.second.compressed.data(),
+                                        p1.second.compressed.size()};
+                                    m.m_recv_futures.emplace_back(
+                                        typename std::remove_reference_t<decltype(m)>::hook_future_type{
+                                            &p1.second,
+                                            m_comm.recv(msg, p1.second.address, p1.second.tag).m_handle});
+                                    continue;
+                                }
+                                // receive directly into field memory if possible
+                                if (p1.second.zero_copy_ptr)
+                                {
+                                    tl::cb::ref_message<unsigned char> msg{p1.second.zero_copy_ptr, p1.second.size};
+                                    m.m_recv_futures.emplace_back(
+                                        typename std::remove_reference_t<decltype(m)>::hook_future_type{
+                                            &p1.second,
+                                            m_comm.recv(msg, p1.second.address, p1.second.tag).m_handle});
+                                    continue;
+                                }
                                 p1.second.buffer.resize(p1.second.size);
                                 m.m_recv_futures.emplace_back(
                                     typename std::remove_reference_t<decltype(m)>::hook_future_type{
@@ -522,14 +1218,100 @@ namespace gridtools {
                 detail::for_each(m_mem, [this](auto& m)
                 {
                     using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
-                    packer<arch_type>::pack(m,m_send_futures,m_comm);
+                    if (m_parallel_packing && std::is_same<arch_type,cpu>::value)
+                        parallel_packer::pack(m,m_send_futures,m_comm,m_num_pack_threads,&pattern_type::num_elements);
+                    else
+                        packer<arch_type>::pack(m,m_send_futures,m_comm);
+                });
+                if (!m_compression) return;
+                for (const auto& p0 : std::get<buffer_memory<cpu>>(m_mem).send_memory)
+                    for (const auto& p1 : p0.second)
+                        if (p1.second.size > 0u && p1.second.codec)
+                        {
+                            m_compression_stats.raw_bytes += p1.second.size;
+                            m_compression_stats.message_bytes += p1.second.compressed.size();
+                        }
+            }
+
+            // freeze the current buffer layout: buffers are allocated to their final size and are retained
+            // after each exchange
+            void make_persistent()
+            {
+                m_valid = false;
+                m_planned = true;
+                if (m_use_mpi_datatypes)
+                {
+                    m_datatype_cache.insert(std::make_pair(std::vector<const void*>{}, make_datatypes()));
+                    return;
+                }
+                // persistent requests are only used when all buffers reside in host memory
+                bool host_only = true;
+                detail::for_each(m_mem, [&host_only](auto& m)
+                {
+                    using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
+                    const bool host = std::is_same<arch_type,cpu>::value;
+                    for (auto& p0 : m.send_memory)
+                        for (auto& p1 : p0.second)
+                            if (p1.second.size > 0u)
+                            {
+                                if (!p1.second.zero_copy_ptr) p1.second.buffer.resize(p1.second.size);
+                                host_only = host_only && host;
+                            }
+                    for (auto& p0 : m.recv_memory)
+                        for (auto& p1 : p0.second)
+                            if (p1.second.size > 0u)
+                            {
+                                if (!p1.second.zero_copy_ptr) p1.second.buffer.resize(p1.second.size);
+                                host_only = host_only && host;
+                            }
                 });
+                if (m_use_persistent_requests && !m_parallel_packing && !m_compression && host_only)
+                    m_persistent_requests.init(m_comm, std::get<buffer_memory<cpu>>(m_mem));
+            }
+
+            // start an exchange using the buffers set up in make_exchange_plan
+            handle_type exchange_planned()
+            {
+                if (m_valid)
+                    throw std::runtime_error("earlier exchange operation was not finished");
+                m_valid = true;
+                handle_type h(m_comm, [this](){this->wait();}, [this](){return this->test();});
+                if (m_use_mpi_datatypes)
+                {
+                    m_datatypes = &(m_datatype_cache.begin()->second);
+                    post_datatypes(m_comm, 0);
+                    return h;
+                }
+                if (m_persistent_requests.enabled())
+                {
+                    m_persistent_requests.start();
+                    copy_local();
+                    return h;
+                }
+                post_recvs();
+                pack();
+                copy_local();
+                return h;
             }
 
         private: // wait functions
             void wait()
             {
                 if (!m_valid) return;
+                if (m_datatypes)
+                {
+                    // data is received in place, no unpacking needed
+                    await_requests(m_datatype_futures);
+                    m_datatypes = nullptr;
+                    clear();
+                    return;
+                }
+                if (m_persistent_requests.enabled())
+                {
+                    m_persistent_requests.wait([this](const auto& b){ this->notify(b); });
+                    clear();
+                    return;
+                }
                 // wait for data to arrive (unpack callback will be invoked)
 #ifdef GHEX_COMM_OBJ_USE_FAT_CALLBACKS
                 await_requests(m_recv_reqs, [comm = m_comm]() mutable {comm.progress();});
@@ -537,21 +1319,99 @@ namespace gridtools {
                 detail::for_each(m_mem, [this](auto& m)
                 {
                     using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
-                    packer<arch_type>::unpack(m);
+                    using hook_type = typename std::remove_reference_t<decltype(m)>::hook_type;
+                    if (m_parallel_packing && std::is_same<arch_type,cpu>::value)
+                        parallel_packer::unpack(m,m_num_pack_threads,&pattern_type::num_elements,
+                            [this](const auto& b){ this->notify(b); });
+                    else
+                        await_futures(m.m_recv_futures, [this](hook_type hook)
+                        {
+                            packer<arch_type>::unpack(*hook, hook->buffer.data());
+                            if (std::is_same<arch_type,cpu>::value) this->notify(*hook);
+                        });
                 });
 #endif
                 // wait for data to be sent
                 await_requests(m_send_futures);
 #ifdef __CUDACC__
                 // wait for the unpack kernels to finish
+                sync_streams();
+#endif
+                clear();
+            }
+
+            // unpack the data which has arrived without blocking, finishes the exchange if all messages were
+            // transferred
+            bool test()
+            {
+                if (!m_valid) return true;
+                if (m_datatypes)
+                {
+                    for (auto& f : m_datatype_futures)
+                        if (!f.test()) return false;
+                    m_datatypes = nullptr;
+                    clear();
+                    return true;
+                }
+                if (m_persistent_requests.enabled())
+                {
+                    if (!m_persistent_requests.test([this](const auto& b){ this->notify(b); })) return false;
+                    clear();
+                    return true;
+                }
+#ifdef GHEX_COMM_OBJ_USE_FAT_CALLBACKS
+                m_comm.progress();
+                for (auto& r : m_recv_reqs)
+                    if (!r.test()) return false;
+#else
+                bool recvs_done = true;
+                detail::for_each(m_mem, [this,&recvs_done](auto& m)
+                {
+                    using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
+                    auto& futures = m.m_recv_futures;
+                    // unpack arrived buffers and drop their futures
+                    futures.erase(std::remove_if(futures.begin(), futures.end(), [this](auto& f)
+                        {
+                            if (!f.test()) return false;
+                            auto hook = f.get();
+                            packer<arch_type>::unpack(*hook, hook->buffer.data());
+                            if (std::is_same<arch_type,cpu>::value) this->notify(*hook);
+                            return true;
+                        }), futures.end());
+                    recvs_done = recvs_done && futures.empty();
+                });
+                if (!recvs_done) return false;
+#endif
+                for (auto& f : m_send_futures)
+                    if (!f.test()) return false;
+#ifdef __CUDACC__
+                sync_streams();
+#endif
+                clear();
+                return true;
+            }
+
+            // invoke the neighbor callback for a receive buffer
+            template<typename Buffer>
+            void notify(const Buffer& b)
+            {
+                if (m_neighbor_callback) m_neighbor_callback(b.domain_ids.first_id, b.domain_ids.second_id);
+            }
+
+#ifdef __CUDACC__
+            // wait for the unpack kernels to finish
+            void sync_streams()
+            {
                 auto& m = std::get<buffer_memory<gpu>>(m_mem);
                 for (auto& p0 : m.recv_memory)
                     for (auto& p1: p0.second)
                         if (p1.second.size > 0u)
+                        {
                             p1.second.m_cuda_stream.sync();
-#endif
-                clear();
+                            notify(p1.second);
+                        }
             }
+#endif
 
 #if defined(__CUDACC__) && !defined(GHEX_COMM_OBJ_USE_FAT_CALLBACKS)
             template<typename FieldType>
@@ -572,11 +1432,7 @@ namespace gridtools {
                 // wait for data to be sent
                 await_requests(m_send_futures);
                 // wait for the unpack kernels to finish
-                auto& m = std::get<buffer_memory<gpu>>(m_mem);
-                for (auto& p0 : m.recv_memory)
-                    for (auto& p1: p0.second)
-                        if (p1.second.size > 0u)
-                            p1.second.m_cuda_stream.sync();
+                sync_streams();
                 clear();
             }
 #endif
@@ -588,14 +1444,17 @@ namespace gridtools {
             {
                 m_valid = false;
                 m_send_futures.clear();
+                m_datatype_futures.clear();
 #ifdef GHEX_COMM_OBJ_USE_FAT_CALLBACKS
                 m_recv_reqs.clear();
+                if (m_planned) return;
                 detail::for_each(m_mem, [this](auto& m)
                 {
 #else
                 detail::for_each(m_mem, [this](auto& m)
                 {
                     m.m_recv_futures.clear();
+                    if (m_planned) return;
 #endif
                     for (auto& p0 : m.send_memory)
                         for (auto& p1 : p0.second)
@@ -603,6 +1462,7 @@ namespace gridtools {
                             p1.second.buffer.resize(0);
                             p1.second.size = 0;
                             p1.second.field_infos.resize(0);
+                            p1.second.zero_copy_ptr = nullptr;
                         }
                     for (auto& p0 : m.recv_memory)
                         for (auto& p1 : p0.second)
@@ -610,6 +1470,7 @@ namespace gridtools {
                             p1.second.buffer.resize(0);
                             p1.second.size = 0;
                             p1.second.field_infos.resize(0);
+                            p1.second.zero_copy_ptr = nullptr;
                         }
                 });
             }
@@ -618,7 +1479,7 @@ namespace gridtools {
             template<typename Arch, typename T, typename Memory, typename Field, typename O>
             void allocate(Memory& mem, const pattern_type& pattern, Field* field_ptr, domain_id_type dom_id, typename arch_traits<Arch>::device_id_type device_id, O tag_offset)
             {
-                auto& pool = mem->m_pools[device_id];
+                auto& pool = (*mem->m_pools)[device_id];
                 if (!pool)
                 {
                     pool.reset( new typename arch_traits<Arch>::pool_type{ typename arch_traits<Arch>::basic_allocator_type{} } );
@@ -664,6 +1525,8 @@ namespace gridtools {
                     if (num_elements < 1) continue;
                     const auto remote_address = p_id_c.first.address;
                     const auto remote_dom_id  = p_id_c.first.id;
+                    // tags of different epochs are interleaved
+                    const int tag = (p_id_c.first.tag+tag_offset)*m_num_epochs + m_epoch;
                     domain_id_type left, right;
                     if (receive) 
                     {
@@ -683,7 +1546,7 @@ namespace gridtools {
                             d_p,
                             BufferType{
                                 remote_address,
-                                p_id_c.first.tag+tag_offset,
+                                tag,
                                 arch_traits<Arch>::make_message(pool, device_id),
                                 0,
                                 std::vector<typename BufferType::field_info_type>(),
@@ -693,18 +1556,86 @@ namespace gridtools {
                     else if (it->second.size==0)
                     {
                         it->second.address = remote_address;
-                        it->second.tag = p_id_c.first.tag+tag_offset;
+                        it->second.tag = tag;
                         it->second.field_infos.resize(0);
                     }
+                    it->second.domain_ids = d_p;
                     const auto prev_size = it->second.size;
                     const auto padding = ((prev_size+alignof(ValueType)-1)/alignof(ValueType))*alignof(ValueType) - prev_size;
                     it->second.field_infos.push_back(
-                        typename BufferType::field_info_type{std::forward<Function>(func), &p_id_c.second, prev_size + padding, field_ptr});
+                        typename BufferType::field_info_type{std::forward<Function>(func), &p_id_c.second, prev_size + padding, field_ptr,
+                            m_use_mpi_datatypes ?
+                                detail::datatype_function<typename BufferType::field_info_type::index_container_type>(field_ptr, 0) :
+                                typename BufferType::field_info_type::datatype_function_type{},
+                            sizeof(ValueType)*field_ptr->num_components(),
+                            (std::is_same<Arch,cpu>::value && !receive) ?
+                                detail::local_copy_function<typename BufferType::field_info_type::index_container_type>(field_ptr, 0) :
+                                typename BufferType::field_info_type::local_copy_function_type{},
+                            detail::type_tag<Field>(),
+                            detail::fused_function<typename BufferType::field_info_type::index_container_type>(
+                                field_ptr, receive, 0)});
                     it->second.size += padding + static_cast<std::size_t>(num_elements)*sizeof(ValueType);
+                    // messages are compressed with the codec of the first field
+                    if (it->second.field_infos.size() == 1u)
+                        it->second.codec = (m_compression && std::is_same<Arch,cpu>::value) ?
+                            compression::codec_traits<Field>::get() : nullptr;
+                    // a buffer holding a single contiguous region of host memory is bypassed
+                    it->second.zero_copy_ptr = (std::is_same<Arch,cpu>::value && it->second.field_infos.size() == 1u) ?
+                        detail::contiguous_ptr(field_ptr, p_id_c.second, 0) : nullptr;
                 }
             }
         };
 
+        /** @brief a precompiled exchange for a fixed set of fields, created through
+          * communication_object::make_exchange_plan. Communication buffers are allocated once and reused
+          * for every exchange.
+          * @tparam Communicator communicator type
+          * @tparam GridType grid tag type
+          * @tparam DomainIdType domain id type*/
+        template<typename Communicator, typename GridType, typename DomainIdType>
+        class exchange_plan
+        {
+        private: // friend class
+            friend class communication_object<Communicator,GridType,DomainIdType>;
+
+        public: // member types
+            using co_type     = communication_object<Communicator,GridType,DomainIdType>;
+            using handle_type = typename co_type::handle_type;
+
+        private: // members
+            std::unique_ptr<co_type> m_co;
+
+        private: // private constructor called through make_exchange_plan
+            exchange_plan(std::unique_ptr<co_type>&& co) noexcept : m_co{std::move(co)} {}
+
+        public: // copy and move ctors
+            exchange_plan(exchange_plan&&) = default;
+            exchange_plan(const exchange_plan&) = delete;
+            exchange_plan& operator=(exchange_plan&&) = default;
+            exchange_plan& operator=(const exchange_plan&) = delete;
+
+        public: // member functions
+            /** @brief non-blocking exchange of the planned fields
+              * @return handle to await communication */
+            [[nodiscard]] handle_type exchange() { return m_co->exchange_planned(); }
+
+            /** @brief blocking exchange of the planned fields */
+            void bexchange() { exchange().wait(); }
+
+            /** @brief set up the plan again for a (possibly different) set of fields, e.g. after the patterns were
+              * updated. The memory pools of the plan are reused.
+              * @tparam Archs list of device types
+              * @tparam Fields list of field types
+              * @param buffer_infos buffer_info objects created by binding a field descriptor to a pattern */
+            template<typename... Archs, typename... Fields>
+            void refresh(buffer_info<typename co_type::pattern_type,Archs,Fields>... buffer_infos)
+            {
+                m_co->refresh();
+                m_co->exchange_impl(buffer_infos...);
+                m_co->make_persistent();
+            }
+        };
+
         /** @brief creates a communication object based on the pattern type
           * @tparam PatternContainer pattern type
           * @return communication object */
@@ -717,6 +1648,21 @@ namespace gridtools {
             return communication_object<communicator_type,grid_type,domain_id_type>(comm);
         }
 
+        /** @brief creates a communication object based on the pattern type which allows for several exchanges in
+          * flight at the same time
+          * @tparam PatternContainer pattern type
+          * @param comm communicator
+          * @param num_epochs number of exchanges which may be in flight concurrently
+          * @return communication object */
+        template<typename PatternContainer>
+        auto make_communication_object(typename PatternContainer::value_type::communicator_type comm, int num_epochs)
+        {
+            using communicator_type = typename PatternContainer::value_type::communicator_type;
+            using grid_type         = typename PatternContainer::value_type::grid_type;
+            using domain_id_type    = typename PatternContainer::value_type::domain_id_type;
+            return communication_object<communicator_type,grid_type,domain_id_type>(comm, num_epochs);
+        }
+
     } // namespace ghex
         
 } // namespace gridtools
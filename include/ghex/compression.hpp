@@ -0,0 +1,296 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_COMPRESSION_HPP
+#define INCLUDED_GHEX_COMPRESSION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace gridtools {
+
+    namespace ghex {
+
+        namespace compression {
+
+            /** @brief interface of a lossless codec which is applied to halo messages */
+            class codec
+            {
+            public: // dtor
+                virtual ~codec() {}
+
+            public: // member functions
+                /** @brief compress a byte sequence
+                  * @param src source bytes
+                  * @param size number of source bytes
+                  * @param dst destination memory
+                  * @param capacity size of the destination memory
+                  * @return compressed size, or 0 if the compressed data does not fit into capacity */
+                virtual std::size_t compress(const unsigned char* src, std::size_t size, unsigned char* dst,
+                    std::size_t capacity) const = 0;
+
+                /** @brief decompress a byte sequence
+                  * @param src compressed bytes
+                  * @param compressed_size number of compressed bytes
+                  * @param dst destination memory
+                  * @param size size of the uncompressed data */
+                virtual void decompress(const unsigned char* src, std::size_t compressed_size, unsigned char* dst,
+                    std::size_t size) const = 0;
+            };
+
+            namespace detail {
+                inline std::uint32_t read32(const unsigned char* p) noexcept
+                {
+                    std::uint32_t v;
+                    std::memcpy(&v, p, sizeof(v));
+                    return v;
+                }
+
+                // length continuation bytes (255, 255, ..., rest)
+                inline bool write_length(unsigned char*& op, const unsigned char* oend, std::size_t len) noexcept
+                {
+                    while (len >= 255u)
+                    {
+                        if (op == oend) return false;
+                        *op++ = 255u;
+                        len -= 255u;
+                    }
+                    if (op == oend) return false;
+                    *op++ = static_cast<unsigned char>(len);
+                    return true;
+                }
+
+                inline std::size_t read_length(const unsigned char*& ip) noexcept
+                {
+                    std::size_t len = 0;
+                    unsigned char b;
+                    do { b = *ip++; len += b; } while (b == 255u);
+                    return len;
+                }
+
+                // emit one sequence: token, literals and (if match_len > 0) offset and match length
+                inline bool write_sequence(unsigned char*& op, const unsigned char* oend, const unsigned char* lit,
+                    std::size_t lit_len, std::size_t offset, std::size_t match_len) noexcept
+                {
+                    static constexpr std::size_t min_match = 4;
+                    if (op == oend) return false;
+                    unsigned char& token = *op++;
+                    token = static_cast<unsigned char>((lit_len < 15u ? lit_len : 15u) << 4);
+                    if (lit_len >= 15u && !write_length(op, oend, lit_len-15u)) return false;
+                    if (static_cast<std::size_t>(oend-op) < lit_len) return false;
+                    std::memcpy(op, lit, lit_len);
+                    op += lit_len;
+                    if (match_len == 0u) return true;
+                    if (oend-op < 2) return false;
+                    *op++ = static_cast<unsigned char>(offset & 0xffu);
+                    *op++ = static_cast<unsigned char>(offset >> 8);
+                    const std::size_t ml = match_len - min_match;
+                    token |= static_cast<unsigned char>(ml < 15u ? ml : 15u);
+                    return ml < 15u || write_length(op, oend, ml-15u);
+                }
+            } // namespace detail
+
+            /** @brief byte oriented LZ77 block compression in the spirit of LZ4: a sequence of literal runs and
+              * back-references (offset < 64 KiB, length >= 4) found through a hash table of 4-byte prefixes. */
+            struct lz
+            {
+                static std::size_t compress(const unsigned char* src, std::size_t size, unsigned char* dst,
+                    std::size_t capacity) noexcept
+                {
+                    static constexpr int hash_bits = 12;
+                    static constexpr std::size_t min_match = 4;
+                    static constexpr std::size_t last_literals = 5;
+                    static constexpr std::size_t max_offset = 65535;
+                    std::uint32_t table[1u<<hash_bits] = {};
+                    unsigned char* op = dst;
+                    const unsigned char* oend = dst + capacity;
+                    std::size_t anchor = 0;
+                    if (size > min_match + last_literals)
+                    {
+                        const std::size_t match_limit = size - last_literals;
+                        std::size_t ip = 0;
+                        while (ip + min_match <= match_limit)
+                        {
+                            const auto seq = detail::read32(src+ip);
+                            const auto h = (seq * 2654435761u) >> (32 - hash_bits);
+                            const std::size_t ref = table[h];
+                            table[h] = static_cast<std::uint32_t>(ip);
+                            if (ref < ip && ip - ref <= max_offset && detail::read32(src+ref) == seq)
+                            {
+                                std::size_t len = min_match;
+                                while (ip + len < match_limit && src[ref+len] == src[ip+len]) ++len;
+                                if (!detail::write_sequence(op, oend, src+anchor, ip-anchor, ip-ref, len)) return 0;
+                                ip += len;
+                                anchor = ip;
+                            }
+                            else
+                                ++ip;
+                        }
+                    }
+                    if (!detail::write_sequence(op, oend, src+anchor, size-anchor, 0, 0)) return 0;
+                    return static_cast<std::size_t>(op - dst);
+                }
+
+                static void decompress(const unsigned char* src, std::size_t compressed_size, unsigned char* dst,
+                    std::size_t size)
+                {
+                    static constexpr std::size_t min_match = 4;
+                    const unsigned char* ip = src;
+                    const unsigned char* iend = src + compressed_size;
+                    unsigned char* op = dst;
+                    unsigned char* oend = dst + size;
+                    while (ip < iend)
+                    {
+                        const unsigned char token = *ip++;
+                        std::size_t lit_len = token >> 4;
+                        if (lit_len == 15u) lit_len += detail::read_length(ip);
+                        if (static_cast<std::size_t>(oend-op) < lit_len)
+                            throw std::runtime_error("corrupt compressed message");
+                        std::memcpy(op, ip, lit_len);
+                        op += lit_len;
+                        ip += lit_len;
+                        if (ip >= iend) break;
+                        const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+                        ip += 2;
+                        std::size_t match_len = token & 15u;
+                        if (match_len == 15u) match_len += detail::read_length(ip);
+                        match_len += min_match;
+                        if (offset == 0u || static_cast<std::size_t>(op-dst) < offset ||
+                            static_cast<std::size_t>(oend-op) < match_len)
+                            throw std::runtime_error("corrupt compressed message");
+                        // the regions may overlap: copy byte by byte
+                        const unsigned char* match = op - offset;
+                        for (std::size_t i=0; i<match_len; ++i) *op++ = *match++;
+                    }
+                    if (op != oend)
+                        throw std::runtime_error("corrupt compressed message");
+                }
+            };
+
+            /** @brief default codec: the bytes of the values are regrouped by significance (byte shuffle) before
+              * LZ compression. For smooth floating point data the sign, exponent and leading mantissa bytes form
+              * long runs which compress well. */
+            class shuffle_lz_codec : public codec
+            {
+            private: // members
+                std::size_t m_type_size;
+
+            public: // ctors
+                /** @brief construct a codec
+                  * @param type_size size of the values in bytes */
+                shuffle_lz_codec(std::size_t type_size) : m_type_size{type_size} {}
+
+            public: // member functions
+                std::size_t type_size() const noexcept { return m_type_size; }
+
+                std::size_t compress(const unsigned char* src, std::size_t size, unsigned char* dst,
+                    std::size_t capacity) const override
+                {
+                    auto& tmp = scratch();
+                    tmp.resize(size);
+                    shuffle(src, size, tmp.data());
+                    return lz::compress(tmp.data(), size, dst, capacity);
+                }
+
+                void decompress(const unsigned char* src, std::size_t compressed_size, unsigned char* dst,
+                    std::size_t size) const override
+                {
+                    auto& tmp = scratch();
+                    tmp.resize(size);
+                    lz::decompress(src, compressed_size, tmp.data(), size);
+                    unshuffle(tmp.data(), size, dst);
+                }
+
+            private: // implementation
+                static std::vector<unsigned char>& scratch()
+                {
+                    static thread_local std::vector<unsigned char> s;
+                    return s;
+                }
+
+                void shuffle(const unsigned char* src, std::size_t size, unsigned char* dst) const noexcept
+                {
+                    const std::size_t n = size / m_type_size;
+                    for (std::size_t b=0; b<m_type_size; ++b)
+                        for (std::size_t i=0; i<n; ++i)
+                            dst[b*n+i] = src[i*m_type_size+b];
+                    std::memcpy(dst+n*m_type_size, src+n*m_type_size, size-n*m_type_size);
+                }
+
+                void unshuffle(const unsigned char* src, std::size_t size, unsigned char* dst) const noexcept
+                {
+                    const std::size_t n = size / m_type_size;
+                    for (std::size_t b=0; b<m_type_size; ++b)
+                        for (std::size_t i=0; i<n; ++i)
+                            dst[i*m_type_size+b] = src[b*n+i];
+                    std::memcpy(dst+n*m_type_size, src+n*m_type_size, size-n*m_type_size);
+                }
+            };
+
+            /** @brief selects the codec for the messages of a field type. Specialize this class to use a
+              * different codec for a field type, or return nullptr to exchange the field uncompressed. If
+              * several fields share a message, the codec of the first field is used.
+              * @tparam Field field type */
+            template<typename Field>
+            struct codec_traits
+            {
+                static const codec* get()
+                {
+                    static const shuffle_lz_codec c(sizeof(typename Field::value_type));
+                    return &c;
+                }
+            };
+
+            // message layout: 8 byte header holding the compressed payload size (0: payload is not compressed)
+            using header_type = std::uint64_t;
+
+            /** @brief upper bound of the size of an encoded message */
+            inline std::size_t max_message_size(std::size_t size) noexcept { return sizeof(header_type) + size; }
+
+            /** @brief encode a message: data is stored uncompressed if the codec does not reduce its size
+              * @param c codec
+              * @param src uncompressed data
+              * @param size size of uncompressed data
+              * @param msg message (resized to the encoded size) */
+            template<typename Vector>
+            inline void encode(const codec& c, const unsigned char* src, std::size_t size, Vector& msg)
+            {
+                msg.resize(max_message_size(size));
+                header_type compressed_size = c.compress(src, size, msg.data()+sizeof(header_type), size);
+                if (compressed_size == 0u)
+                    std::memcpy(msg.data()+sizeof(header_type), src, size);
+                std::memcpy(msg.data(), &compressed_size, sizeof(header_type));
+                msg.resize(sizeof(header_type) + (compressed_size ? compressed_size : size));
+            }
+
+            /** @brief decode a message
+              * @param c codec
+              * @param msg encoded message
+              * @param dst destination memory
+              * @param size size of uncompressed data */
+            inline void decode(const codec& c, const unsigned char* msg, unsigned char* dst, std::size_t size)
+            {
+                header_type compressed_size;
+                std::memcpy(&compressed_size, msg, sizeof(header_type));
+                if (compressed_size == 0u)
+                    std::memcpy(dst, msg+sizeof(header_type), size);
+                else
+                    c.decompress(msg+sizeof(header_type), compressed_size, dst, size);
+            }
+
+        } // namespace compression
+
+    } // namespace ghex
+
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_COMPRESSION_HPP */
@@ -16,12 +16,110 @@
 #include "./structured/field_utils.hpp"
 #include "./cuda_utils/kernel_argument.hpp"
 #include "./cuda_utils/future.hpp"
+#include "./transport_layer/callback_utils.hpp"
+#include "./compression.hpp"
+#include "./common/streaming_stores.hpp"
 #include <gridtools/common/array.hpp>
+#include <vector>
 
 namespace gridtools {
 
     namespace ghex {
 
+        namespace detail {
+            // returns the field memory of a buffer which is sent from or received into directly (zero-copy)
+            template<typename Buffer>
+            inline auto zero_copy_ptr(const Buffer& b, int) noexcept -> decltype(b.zero_copy_ptr) { return b.zero_copy_ptr; }
+            template<typename Buffer>
+            inline unsigned char* zero_copy_ptr(const Buffer&, long) noexcept { return nullptr; }
+            template<typename Buffer>
+            inline unsigned char* zero_copy_ptr(const Buffer& b) noexcept { return zero_copy_ptr(b, 0); }
+
+            // send a packed buffer (compressed if the buffer has a codec)
+            template<typename Buffer, typename Futures, typename Communicator>
+            inline auto send_buffer(Buffer& b, Futures& send_futures, Communicator& comm, int)
+            -> decltype(b.codec, b.compressed, void())
+            {
+                if (!b.codec)
+                {
+                    send_futures.push_back(comm.send(b.buffer, b.address, b.tag));
+                    return;
+                }
+                compression::encode(*b.codec, b.buffer.data(), b.size, b.compressed);
+                send_futures.push_back(comm.send(tl::cb::ref_message<unsigned char>{b.compressed.data(),
+                    b.compressed.size()}, b.address, b.tag));
+            }
+            template<typename Buffer, typename Futures, typename Communicator>
+            inline void send_buffer(Buffer& b, Futures& send_futures, Communicator& comm, long)
+            {
+                send_futures.push_back(comm.send(b.buffer, b.address, b.tag));
+            }
+            template<typename Buffer, typename Futures, typename Communicator>
+            inline void send_buffer(Buffer& b, Futures& send_futures, Communicator& comm)
+            {
+                send_buffer(b, send_futures, comm, 0);
+            }
+
+            // returns the received data of a buffer (decompressed if the buffer has a codec)
+            template<typename Buffer>
+            inline auto received_data(Buffer& b, unsigned char* data, int) -> decltype(b.codec, b.compressed, (unsigned char*)nullptr)
+            {
+                if (!b.codec) return data;
+                b.buffer.resize(b.size);
+                compression::decode(*b.codec, b.compressed.data(), b.buffer.data(), b.size);
+                return b.buffer.data();
+            }
+            template<typename Buffer>
+            inline unsigned char* received_data(Buffer&, unsigned char* data, long) { return data; }
+            template<typename Buffer>
+            inline unsigned char* received_data(Buffer& b, unsigned char* data) { return received_data(b, data, 0); }
+
+            // invoke the pack (unpack) functions of the fields of a buffer: consecutive fields with the same fused
+            // function and the same iteration spaces are processed together in one traversal
+            template<typename FieldInfos, typename Data>
+            inline auto for_each_field(const FieldInfos& field_infos, Data* data, int)
+            -> decltype(field_infos.front().fused, void())
+            {
+                static thread_local std::vector<void*> fields;
+                static thread_local std::vector<void*> buffers;
+                const std::size_t num_fields = field_infos.size();
+                for (std::size_t i=0; i<num_fields;)
+                {
+                    const auto& fb = field_infos[i];
+                    std::size_t j = i+1;
+                    if (fb.fused)
+                        while (j<num_fields && field_infos[j].fused == fb.fused &&
+                            field_infos[j].index_container == fb.index_container) ++j;
+                    if (j-i == 1u)
+                    {
+                        fb.call_back(data + fb.offset, *fb.index_container, nullptr);
+                        ++i;
+                        continue;
+                    }
+                    fields.clear();
+                    buffers.clear();
+                    for (std::size_t k=i; k<j; ++k)
+                    {
+                        fields.push_back(field_infos[k].field_ptr);
+                        buffers.push_back((void*)(data + field_infos[k].offset));
+                    }
+                    fb.fused(fields.data(), buffers.data(), j-i, *fb.index_container);
+                    i = j;
+                }
+            }
+            template<typename FieldInfos, typename Data>
+            inline void for_each_field(const FieldInfos& field_infos, Data* data, long)
+            {
+                for (const auto& fb : field_infos)
+                    fb.call_back(data + fb.offset, *fb.index_container, nullptr);
+            }
+            template<typename FieldInfos, typename Data>
+            inline void for_each_field(const FieldInfos& field_infos, Data* data)
+            {
+                for_each_field(field_infos, data, 0);
+            }
+        } // namespace detail
+
         /** @brief generic implementation of pack and unpack */
         template<typename Arch>
         struct packer
@@ -35,10 +133,20 @@ namespace gridtools {
                     {
                         if (p1.second.size > 0u)
                         {
+                            if (auto ptr = detail::zero_copy_ptr(p1.second))
+                            {
+                                // send directly from field memory
+                                send_futures.push_back(comm.send(tl::cb::ref_message<unsigned char>{ptr, p1.second.size},
+                                    p1.second.address, p1.second.tag));
+                                continue;
+                            }
                             p1.second.buffer.resize(p1.second.size);
-                            for (const auto& fb : p1.second.field_infos)
-                                fb.call_back( p1.second.buffer.data() + fb.offset, *fb.index_container, nullptr);
-                            send_futures.push_back(comm.send(p1.second.buffer, p1.second.address, p1.second.tag));
+                            {
+                                // large buffers are written with non-temporal stores
+                                const streaming_stores::scope s(p1.second.size);
+                                detail::for_each_field(p1.second.field_infos, p1.second.buffer.data());
+                            }
+                            detail::send_buffer(p1.second, send_futures, comm);
                         }
                     }
                 }
@@ -47,8 +155,11 @@ namespace gridtools {
             template<typename Buffer>
             static void unpack(Buffer& buffer, unsigned char* data)
             {
-                for (const auto& fb :  buffer.field_infos)
-                    fb.call_back(data + fb.offset, *fb.index_container, nullptr);
+                // data was received in place
+                if (detail::zero_copy_ptr(buffer)) return;
+                data = detail::received_data(buffer, data);
+                const streaming_stores::scope s(buffer.size);
+                detail::for_each_field(buffer.field_infos, data);
             }
 
             template<typename BufferMem>
@@ -58,8 +169,10 @@ namespace gridtools {
                     m.m_recv_futures,
                     [](typename BufferMem::hook_type hook)
                     {
-                        for (const auto& fb :  hook->field_infos)
-                            fb.call_back(hook->buffer.data() + fb.offset, *fb.index_container, nullptr);
+                        // data was received in place
+                        if (detail::zero_copy_ptr(*hook)) return;
+                        const streaming_stores::scope s(hook->size);
+                        detail::for_each_field(hook->field_infos, detail::received_data(*hook, hook->buffer.data()));
                     });
             }
         };
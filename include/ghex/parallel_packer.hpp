@@ -0,0 +1,217 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_PARALLEL_PACKER_HPP
+#define INCLUDED_GHEX_PARALLEL_PACKER_HPP
+
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "./common/await_futures.hpp"
+#include "./packer.hpp"
+
+namespace gridtools {
+
+    namespace ghex {
+
+        namespace detail {
+            // number of threads used for packing (non-positive: OpenMP default)
+            inline int num_pack_threads(int num_threads) noexcept
+            {
+#ifdef _OPENMP
+                return num_threads > 0 ? num_threads : omp_get_max_threads();
+#else
+                return num_threads > 0 ? num_threads : 1;
+#endif
+            }
+
+            /** @brief list of independent pack/unpack tasks: one task per buffer, field and iteration space.
+              * @tparam Buffer buffer type */
+            template<typename Buffer>
+            class pack_tasks
+            {
+            public: // member types
+                using field_info_type      = typename Buffer::field_info_type;
+                using index_container_type = typename field_info_type::index_container_type;
+
+                struct task
+                {
+                    Buffer* buffer;
+                    const field_info_type* field_info;
+                    const index_container_type* index_container;
+                    std::size_t offset;
+                    std::size_t buffer_id;
+
+                    void operator()() const
+                    {
+                        // large buffers are accessed with non-temporal stores (fenced before the task completes)
+                        const streaming_stores::scope s(buffer->size);
+                        field_info->call_back(buffer->buffer.data() + offset, *index_container, nullptr);
+                    }
+                };
+
+            private: // members
+                std::vector<task> m_tasks;
+                std::vector<std::pair<std::size_t,std::size_t>> m_ranges;
+                std::map<const Buffer*, std::size_t> m_ids;
+                // single iteration space containers (pointers must remain valid)
+                std::deque<index_container_type> m_sub_containers;
+
+            public: // member functions
+                std::size_t size() const noexcept { return m_tasks.size(); }
+                std::size_t num_buffers() const noexcept { return m_ranges.size(); }
+                const task& operator[](std::size_t i) const noexcept { return m_tasks[i]; }
+                const std::pair<std::size_t,std::size_t>& range(std::size_t buffer_id) const noexcept { return m_ranges[buffer_id]; }
+                const std::pair<std::size_t,std::size_t>& range(const Buffer* b) const { return m_ranges[m_ids.at(b)]; }
+
+                /** @brief split a buffer into tasks
+                  * @tparam NumElements function object returning the number of elements of an index container
+                  * @param b buffer
+                  * @param num_elements function object */
+                template<typename NumElements>
+                void add(Buffer& b, NumElements&& num_elements)
+                {
+                    const std::size_t id = m_ranges.size();
+                    const std::size_t begin = m_tasks.size();
+                    for (const auto& fi : b.field_infos)
+                    {
+                        const auto& c = *fi.index_container;
+                        if (c.size() < 2u)
+                        {
+                            m_tasks.push_back(task{&b, &fi, &c, fi.offset, id});
+                            continue;
+                        }
+                        std::size_t offset = fi.offset;
+                        for (auto it = c.begin(); it != c.end(); ++it)
+                        {
+                            m_sub_containers.emplace_back(it, std::next(it));
+                            m_tasks.push_back(task{&b, &fi, &m_sub_containers.back(), offset, id});
+                            offset += static_cast<std::size_t>(num_elements(m_sub_containers.back()))*fi.element_size;
+                        }
+                    }
+                    m_ranges.push_back(std::make_pair(begin, m_tasks.size()));
+                    m_ids[&b] = id;
+                }
+            };
+        } // namespace detail
+
+        /** @brief multi-threaded pack and unpack of host buffers. The work is split into tasks (one per neighbor,
+          * field and iteration space) which are distributed among OpenMP threads. A buffer is sent as soon as all of
+          * its tasks are done, and received buffers are unpacked in parallel as they arrive. Messages are posted
+          * and completed buffers are reported from within the thread team (one at a time). Without OpenMP all tasks
+          * are run by the calling thread. */
+        struct parallel_packer
+        {
+            template<typename Map, typename Futures, typename Communicator, typename NumElements>
+            static void pack(Map& map, Futures& send_futures, Communicator& comm, int num_threads, NumElements&& num_elements)
+            {
+                (void)num_threads;
+                using buffer_type = typename Map::send_buffer_type;
+                detail::pack_tasks<buffer_type> tasks;
+                for (auto& p0 : map.send_memory)
+                {
+                    for (auto& p1: p0.second)
+                    {
+                        if (p1.second.size > 0u)
+                        {
+                            if (auto ptr = detail::zero_copy_ptr(p1.second))
+                            {
+                                // send directly from field memory
+                                send_futures.push_back(comm.send(tl::cb::ref_message<unsigned char>{ptr, p1.second.size},
+                                    p1.second.address, p1.second.tag));
+                                continue;
+                            }
+                            p1.second.buffer.resize(p1.second.size);
+                            tasks.add(p1.second, num_elements);
+                        }
+                    }
+                }
+                // number of outstanding tasks per buffer
+                std::unique_ptr<std::atomic<int>[]> remaining{new std::atomic<int>[tasks.num_buffers()]};
+                for (std::size_t i=0; i<tasks.num_buffers(); ++i)
+                    remaining[i] = static_cast<int>(tasks.range(i).second - tasks.range(i).first);
+                const int n = static_cast<int>(tasks.size());
+                #pragma omp parallel for schedule(dynamic) num_threads(detail::num_pack_threads(num_threads))
+                for (int i=0; i<n; ++i)
+                {
+                    const auto& t = tasks[i];
+                    t();
+                    // the thread which completes a buffer sends it
+                    if (remaining[t.buffer_id].fetch_sub(1) == 1)
+                    {
+                        #pragma omp critical(ghex_parallel_packer)
+                        detail::send_buffer(*t.buffer, send_futures, comm);
+                    }
+                }
+            }
+
+            template<typename BufferMem, typename NumElements, typename Continuation>
+            static void unpack(BufferMem& m, int num_threads, NumElements&& num_elements, Continuation&& cont)
+            {
+                (void)num_threads;
+                using buffer_type = typename BufferMem::recv_buffer_type;
+                using hook_type   = typename BufferMem::hook_type;
+                detail::pack_tasks<buffer_type> tasks;
+                for (auto& p0 : m.recv_memory)
+                    for (auto& p1: p0.second)
+                        if (p1.second.size > 0u && !detail::zero_copy_ptr(p1.second))
+                            tasks.add(p1.second, num_elements);
+                // number of outstanding tasks per buffer
+                std::unique_ptr<std::atomic<int>[]> remaining{new std::atomic<int>[tasks.num_buffers()]};
+                for (std::size_t i=0; i<tasks.num_buffers(); ++i)
+                    remaining[i] = static_cast<int>(tasks.range(i).second - tasks.range(i).first);
+                auto* remaining_ptr = remaining.get();
+                // one thread polls the receives and spawns unpack tasks for the arrived buffers
+                #pragma omp parallel num_threads(detail::num_pack_threads(num_threads))
+                #pragma omp single
+                await_futures(m.m_recv_futures, [&tasks,&cont,remaining_ptr](hook_type hook)
+                {
+                    // data was received in place
+                    if (detail::zero_copy_ptr(*hook))
+                    {
+                        #pragma omp critical(ghex_parallel_packer)
+                        cont(*hook);
+                        return;
+                    }
+                    // decompress before the buffer is unpacked in parallel
+                    detail::received_data(*hook, hook->buffer.data());
+                    // tasks may outlive this function object: pass pointers to the shared state
+                    auto* done = &cont;
+                    auto* remaining_tasks = remaining_ptr;
+                    const auto r = tasks.range(hook);
+                    for (auto i = r.first; i < r.second; ++i)
+                    {
+                        const auto* t = &tasks[i];
+                        #pragma omp task firstprivate(t, done, remaining_tasks)
+                        {
+                            (*t)();
+                            // the thread which completes a buffer reports it
+                            if (remaining_tasks[t->buffer_id].fetch_sub(1) == 1)
+                            {
+                                #pragma omp critical(ghex_parallel_packer)
+                                (*done)(*t->buffer);
+                            }
+                        }
+                    }
+                });
+            }
+        };
+
+    } // namespace ghex
+
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_PARALLEL_PACKER_HPP */
@@ -11,6 +11,8 @@
 #ifndef INCLUDED_GHEX_PATTERN_HPP
 #define INCLUDED_GHEX_PATTERN_HPP
 
+#include <utility>
+#include <vector>
 #include "./buffer_info.hpp"
 #include "./transport_layer/context.hpp"
 
@@ -22,6 +24,15 @@ namespace gridtools {
             // forward declaration
             template<typename GridType>
             struct make_pattern_impl;
+            // forward declaration
+            template<typename GridType>
+            struct pattern_io;
+            // forward declaration
+            template<typename GridType>
+            struct update_pattern_impl;
+            // forward declaration
+            template<typename GridType>
+            struct restrict_pattern_impl;
         } // namespace detail
 
         // forward declaration
@@ -41,12 +52,16 @@ namespace gridtools {
             using domain_id_type = DomainIdType;
             /** @brief pattern type this object is holding */
             using value_type = pattern<Communicator,GridType,DomainIdType>;
+            /** @brief a migrated domain: domain id and new owner rank */
+            using migration_type = std::pair<DomainIdType,int>;
 
         private: // private member types
             using data_type  = std::vector<value_type>;
 
         private: // friend declarations
             friend class detail::make_pattern_impl<GridType>;
+            friend class detail::pattern_io<GridType>;
+            friend class detail::update_pattern_impl<GridType>;
 
         public: // copy constructor
             pattern_container(const pattern_container& other)
@@ -84,6 +99,50 @@ namespace gridtools {
             auto cend() const noexcept { return m_patterns.cend(); }
             int max_tag() const noexcept { return m_max_tag; }
 
+            /** @brief update the patterns after domains have migrated between ranks. The patterns of the migrated
+             * domains are moved to their new owners, and only the halos of the domain pairs which involve a
+             * migrated domain are updated, through communication among the affected ranks (and one reduction for
+             * the maximum tag). The container then holds the patterns of the remaining domains, followed by the
+             * patterns of the domains which migrated to this rank. Must be called by all ranks with the same list
+             * of migrations. Communication objects must be refreshed before the next exchange.
+             * @tparam Transport transport protocol
+             * @param context transport layer context
+             * @param migrations list of migrated domains and their new owner ranks */
+            template<typename Transport>
+            void update(tl::context<Transport>& context, const std::vector<migration_type>& migrations)
+            {
+                detail::update_pattern_impl<GridType>::apply(context, *this, migrations);
+            }
+
+            /** @brief derive patterns for narrower halos. The iteration spaces are clipped locally, without
+             * communication, since the sending and receiving sides apply the same clipping. The tags are kept,
+             * such that the derived patterns can be exchanged together with these patterns.
+             * @tparam Halos range type holding halo widths (at most the widths of these patterns)
+             * @param halos halo widths, ordered as (dim0_dir-, dim0_dir+, dim1_dir-, dim1_dir+, ...)
+             * @return restricted patterns */
+            template<typename Halos>
+            pattern_container restrict(const Halos& halos) const
+            {
+                pattern_container res(*this);
+                detail::restrict_pattern_impl<GridType>::apply(res, halos);
+                return res;
+            }
+
+            /** @brief derive patterns for narrower halos and a range of the last dimension (in global
+             * coordinates), see above
+             * @tparam Halos range type holding halo widths
+             * @tparam Range range type holding the first and last index of the last dimension
+             * @param halos halo widths, ordered as (dim0_dir-, dim0_dir+, dim1_dir-, dim1_dir+, ...)
+             * @param k_range first and last index of the last dimension
+             * @return restricted patterns */
+            template<typename Halos, typename Range>
+            pattern_container restrict(const Halos& halos, const Range& k_range) const
+            {
+                pattern_container res(*this);
+                detail::restrict_pattern_impl<GridType>::apply(res, halos, k_range);
+                return res;
+            }
+
             /** @brief bind a field to a pattern
              * @tparam Field field type
              * @param field field instance
@@ -97,6 +156,15 @@ namespace gridtools {
                 throw std::runtime_error("field incompatible with available domains!");
             }
 
+        private: // implementation
+            void reset(data_type&& d, int mt)
+            {
+                m_patterns = std::move(d);
+                m_max_tag = mt;
+                for (auto& p : m_patterns)
+                    p.m_container = this;
+            }
+
         private: // members
             data_type m_patterns;
             int m_max_tag;
@@ -0,0 +1,159 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_BOX_INDEX_HPP
+#define INCLUDED_GHEX_STRUCTURED_BOX_INDEX_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace gridtools {
+namespace ghex {
+namespace structured {
+
+/** @brief spatial index over a set of boxes (inclusive coordinate ranges) which finds the boxes intersecting
+  * a query box. The bounding box of all boxes is divided into a uniform grid of buckets with roughly
+  * one box per bucket, and each box is registered in the buckets it overlaps. Queries visit only the buckets
+  * overlapping the query box.
+  * @tparam Coordinate coordinate type */
+template<typename Coordinate>
+class box_index
+{
+public: // member types
+    using coordinate_type = Coordinate;
+    using element_type    = typename coordinate_type::element_type;
+    using dimension       = typename coordinate_type::dimension;
+    static constexpr int num_dims = dimension::value;
+
+private: // members
+    coordinate_type m_first;
+    coordinate_type m_last;
+    std::array<long, dimension::value> m_cell_size;
+    std::array<long, dimension::value> m_num_cells;
+    // corners of the boxes
+    std::vector<coordinate_type> m_box_first;
+    std::vector<coordinate_type> m_box_last;
+    // boxes per bucket in compressed row storage
+    std::vector<std::size_t> m_offsets;
+    std::vector<std::size_t> m_ids;
+    // query stamps of the boxes (used to report each box once per query)
+    mutable std::vector<std::size_t> m_stamps;
+    mutable std::size_t m_stamp = 0;
+
+public: // ctors
+    /** @brief build the index
+      * @tparam Boxes range type, boxes[i].first() and boxes[i].last() are the corners of box i
+      * @param first lower corner of the bounding box of all boxes
+      * @param last upper corner of the bounding box of all boxes
+      * @param boxes boxes to be indexed, box i is reported as i */
+    template<typename Boxes>
+    box_index(const coordinate_type& first, const coordinate_type& last, const Boxes& boxes)
+    : m_first{first}
+    , m_last{last}
+    , m_stamps(boxes.size(), 0)
+    {
+        const double n = std::max<double>(1.0, boxes.size());
+        const long cells = std::max(1l, std::lround(std::pow(n, 1.0/dimension::value)));
+        long total = 1;
+        for (int d=0; d<num_dims; ++d)
+        {
+            const long ext = static_cast<long>(m_last[d])-m_first[d]+1;
+            m_num_cells[d] = std::max(1l, std::min(cells, ext));
+            m_cell_size[d] = (ext+m_num_cells[d]-1)/m_num_cells[d];
+            total *= m_num_cells[d];
+        }
+        // count, then fill the buckets
+        m_offsets.assign(total+1, 0);
+        m_box_first.reserve(boxes.size());
+        m_box_last.reserve(boxes.size());
+        for (const auto& b : boxes)
+        {
+            m_box_first.push_back(coordinate_type{b.first()});
+            m_box_last.push_back(coordinate_type{b.last()});
+            for_each_cell(b.first(), b.last(), [this](std::size_t c) { ++m_offsets[c+1]; });
+        }
+        for (std::size_t c=0; c<static_cast<std::size_t>(total); ++c) m_offsets[c+1] += m_offsets[c];
+        m_ids.resize(m_offsets.back());
+        std::vector<std::size_t> pos(m_offsets.begin(), m_offsets.end()-1);
+        std::size_t i = 0;
+        for (const auto& b : boxes)
+        {
+            for_each_cell(b.first(), b.last(), [this,&pos,i](std::size_t c) { m_ids[pos[c]++] = i; });
+            ++i;
+        }
+    }
+
+public: // member functions
+    /** @brief append the ids of all boxes which overlap the query box to result (in ascending order, each id once)
+      * @param first lower corner of the query box
+      * @param last upper corner of the query box
+      * @param result vector of box ids */
+    void query(const coordinate_type& first, const coordinate_type& last, std::vector<std::size_t>& result) const
+    {
+        ++m_stamp;
+        const auto s = result.size();
+        for_each_cell(first, last, [this,&first,&last,&result](std::size_t c)
+        {
+            for (std::size_t j=m_offsets[c]; j<m_offsets[c+1]; ++j)
+            {
+                const auto id = m_ids[j];
+                if (m_stamps[id] == m_stamp) continue;
+                m_stamps[id] = m_stamp;
+                if (overlaps(first, last, id)) result.push_back(id);
+            }
+        });
+        std::sort(result.begin()+s, result.end());
+    }
+
+private: // implementation
+    bool overlaps(const coordinate_type& first, const coordinate_type& last, std::size_t id) const noexcept
+    {
+        for (int d=0; d<num_dims; ++d)
+            if (first[d] > m_box_last[id][d] || m_box_first[id][d] > last[d]) return false;
+        return true;
+    }
+
+    // visit the buckets overlapping a box (clipped to the bounding box)
+    template<typename Func>
+    void for_each_cell(const coordinate_type& first, const coordinate_type& last, Func&& f) const
+    {
+        std::array<long, dimension::value> lo, hi;
+        for (int d=0; d<num_dims; ++d)
+        {
+            const long a = std::max<long>(first[d], m_first[d]);
+            const long b = std::min<long>(last[d], m_last[d]);
+            if (a > b) return;
+            lo[d] = (a-m_first[d])/m_cell_size[d];
+            hi[d] = (b-m_first[d])/m_cell_size[d];
+        }
+        auto x = lo;
+        while (true)
+        {
+            std::size_t c = 0;
+            for (int d=num_dims-1; d>=0; --d) c = c*m_num_cells[d] + x[d];
+            f(c);
+            int d = 0;
+            for (; d<num_dims; ++d)
+            {
+                if (++x[d] <= hi[d]) break;
+                x[d] = lo[d];
+            }
+            if (d == num_dims) break;
+        }
+    }
+};
+
+} // namespace structured
+} // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_BOX_INDEX_HPP */
@@ -0,0 +1,450 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_COMMUNICATION_OBJECT_IPR_HPP
+#define INCLUDED_GHEX_STRUCTURED_COMMUNICATION_OBJECT_IPR_HPP
+
+#include <map>
+#include <functional>
+#include <memory>
+
+#include "../arch_traits.hpp"
+#include "../buffer_info.hpp"
+#include "../common/utils.hpp"
+#include "../common/test_eq.hpp"
+#include "../common/await_futures.hpp"
+#include "../communication_object_2.hpp"
+#include "../communication_object_ipr.hpp"
+#include "../cuda_utils/stream.hpp"
+#include "../packer.hpp"
+#include "../pattern.hpp"
+#include "./grid.hpp"
+
+namespace gridtools {
+
+    namespace ghex {
+
+        /** @brief handle type for waiting on asynchronous communication processes.
+          * The wait function is stored in a member.
+          * @tparam Communicator communicator type
+          * @tparam A coordinate array type of the structured grid
+          * @tparam DomainIdType domain id type*/
+        template<typename Communicator, typename A, typename DomainIdType>
+        class communication_handle_ipr<Communicator, structured::detail::grid<A>, DomainIdType>
+        {
+        private: // member types
+            using communicator_type = Communicator;
+            using grid_type         = structured::detail::grid<A>;
+            using domain_id_type    = DomainIdType;
+
+        private: // friend class
+            friend class communication_object_ipr<communicator_type,grid_type,domain_id_type>;
+
+        private: // members
+            std::function<void()> m_wait_fct;
+
+        public: // public constructor
+            /** @brief construct a ready handle */
+            communication_handle_ipr() = default;
+
+        private: // private constructor
+            /** @brief construct a handle with a wait function
+              * @tparam Func function type with signature void()
+              * @param wait_fct wait function */
+            template<typename Func>
+            communication_handle_ipr(Func&& wait_fct) : m_wait_fct(std::forward<Func>(wait_fct)) {}
+
+        public: // copy and move ctors
+            communication_handle_ipr(communication_handle_ipr&&) = default;
+            communication_handle_ipr(const communication_handle_ipr&) = delete;
+            communication_handle_ipr& operator=(communication_handle_ipr&&) = default;
+            communication_handle_ipr& operator=(const communication_handle_ipr&) = delete;
+
+        public: // member functions
+            /** @brief  wait for communication to be finished*/
+            void wait() { if (m_wait_fct) m_wait_fct(); }
+        };
+
+        /** @brief communication object responsible for exchanging halo data on structured grids with in-place
+          * receive. Every field is communicated with its own message. Receive halos which consist of a single
+          * contiguous region of host field memory are received directly into the field, all other halos fall
+          * back to a buffered receive followed by unpacking.
+          * @tparam Communicator communicator type
+          * @tparam A coordinate array type of the structured grid
+          * @tparam DomainIdType domain id type*/
+        template<typename Communicator, typename A, typename DomainIdType>
+        class communication_object_ipr<Communicator, structured::detail::grid<A>, DomainIdType>
+        {
+        public: // member types
+            /** @brief handle type returned by exhange operation */
+            using communicator_type      = Communicator;
+            using grid_type              = structured::detail::grid<A>;
+            using domain_id_type         = DomainIdType;
+            using handle_type            = communication_handle_ipr<communicator_type,grid_type,domain_id_type>;
+            using pattern_type           = pattern<communicator_type,grid_type,domain_id_type>;
+            using pattern_container_type = pattern_container<communicator_type,grid_type,domain_id_type>;
+
+            template<typename D, typename F>
+            using buffer_info_type       = buffer_info<pattern_type,D,F>;
+
+        private: // member types
+            using address_type         = typename communicator_type::address_type;
+            using index_container_type = typename pattern_type::index_container_type;
+            using pack_function_type   = std::function<void(void*,const index_container_type&, void*)>;
+            using unpack_function_type = std::function<void(const void*,const index_container_type&, void*)>;
+
+            /** @brief pair of domain ids + tag id with ordering */
+            struct domain_id_pair_and_tag
+            {
+                domain_id_type first_id;
+                domain_id_type second_id;
+                int tag;
+                bool operator<(const domain_id_pair_and_tag& other) const noexcept
+                {
+                    return (first_id < other.first_id ? true :
+                           (first_id > other.first_id ? false :
+                           (second_id < other.second_id ? true :
+                           (second_id > other.second_id ? false : (tag < other.tag)))));
+                }
+            };
+
+            /** @brief Holds a pointer to a set of iteration spaces and a callback function pointer
+              * which is used to store a field's pack or unpack member function.
+              * This class also stores the offset in the serialized buffer in bytes.
+              * @tparam Function Either pack or unpack function pointer type */
+            template<typename Function>
+            struct field_info
+            {
+                using index_container_type = typename pattern_type::map_type::mapped_type;
+                Function call_back;
+                const index_container_type* index_container;
+                std::size_t offset;
+                void* field_ptr;
+            };
+
+            /** @brief Holds serial buffer memory and meta information associated with it. If the halo is a
+              * single contiguous region of field memory, zero_copy_ptr points to it and the buffer is bypassed.
+              * @tparam Vector contiguous buffer memory type
+              * @tparam Function Either pack or unpack function pointer type */
+            template<class Vector, class Function>
+            struct buffer
+            {
+                using field_info_type = field_info<Function>;
+                address_type address;
+                int tag;
+                Vector buffer;
+                std::size_t size;
+                std::vector<field_info_type> field_infos;
+                cuda::stream m_cuda_stream;
+                unsigned char* zero_copy_ptr = nullptr;
+            };
+
+            /** @brief Holds maps of buffers for send and receive operations indexed by a device id and a
+              * domain_id_pair_and_tag. The tag separates the messages of different fields exchanged between the
+              * same domains, such that each of them may be received in place.
+              * @tparam Arch the device on which the buffer memory is allocated */
+            template<typename Arch>
+            struct buffer_memory
+            {
+                using arch_type        = Arch;
+                using device_id_type   = typename arch_traits<Arch>::device_id_type;
+                using vector_type      = typename arch_traits<Arch>::message_type;
+
+                using send_buffer_type = buffer<vector_type,pack_function_type>;
+                using recv_buffer_type = buffer<vector_type,unpack_function_type>;
+                using send_memory_type = std::map<device_id_type, std::map<domain_id_pair_and_tag,send_buffer_type>>;
+                using recv_memory_type = std::map<device_id_type, std::map<domain_id_pair_and_tag,recv_buffer_type>>;
+
+                std::map<device_id_type, std::unique_ptr<typename arch_traits<Arch>::pool_type>> m_pools;
+                send_memory_type send_memory;
+                recv_memory_type recv_memory;
+
+                using hook_type        = recv_buffer_type*;
+                using hook_future_type = typename communicator_type::template future<hook_type>;
+                std::vector<hook_future_type> m_recv_futures;
+            };
+
+            /** tuple type of buffer_memory (one element for each device in arch_list) */
+            using memory_type = detail::transform<arch_list>::with<buffer_memory>;
+
+        private: // members
+            bool m_valid;
+            communicator_type m_comm;
+            memory_type m_mem;
+            std::vector<typename communicator_type::template future<void>> m_send_futures;
+
+        public: // ctors
+            communication_object_ipr(communicator_type comm)
+            : m_valid(false)
+            , m_comm(comm) {}
+            communication_object_ipr(const communication_object_ipr&) = delete;
+            communication_object_ipr(communication_object_ipr&&) = default;
+
+        public: // exchange arbitrary field-device-pattern combinations
+            /** @brief blocking variant of halo exchange
+              * @tparam Archs list of device types
+              * @tparam Fields list of field (descriptor) types
+              * @param buffer_infos buffer_info objects created by binding a field descriptor to a pattern */
+            template<typename... Archs, typename... Fields>
+            void bexchange(buffer_info_type<Archs,Fields>... buffer_infos)
+            {
+                exchange(buffer_infos...).wait();
+            }
+
+            /** @brief non-blocking exchange of halo data with in-place receive where possible
+              * @tparam Archs list of device types
+              * @tparam Fields list of field (descriptor) types
+              * @param buffer_infos buffer_info objects created by binding a field descriptor to a pattern
+              * @return handle to await communication */
+            template<typename... Archs, typename... Fields>
+            [[nodiscard]] handle_type exchange(buffer_info_type<Archs,Fields>... buffer_infos)
+            {
+                // check that arguments are compatible
+                using test_t = pattern_container<communicator_type,grid_type,domain_id_type>;
+                static_assert(detail::test_eq_t<test_t, typename buffer_info_type<Archs,Fields>::pattern_container_type...>::value,
+                        "patterns are not compatible with this communication object");
+                if (m_valid)
+                    throw std::runtime_error("earlier exchange operation was not finished");
+                m_valid = true;
+
+                // set tag offsets: the n-th field of each domain gets its own tag range, hence its own messages
+                domain_id_type domain_ids[sizeof...(Fields)] = {buffer_infos.get_field().domain_id()...};
+                int max_tags[sizeof...(Fields)] = {buffer_infos.get_pattern_container().max_tag()...};
+                std::map<domain_id_type,int> next_tag_offset;
+                int tag_offsets[sizeof...(Fields)];
+                for (unsigned int k=0; k<sizeof...(Fields); ++k)
+                {
+                    auto& offset = next_tag_offset[domain_ids[k]];
+                    tag_offsets[k] = offset;
+                    offset += max_tags[k]+1;
+                }
+                // store arguments and corresponding memory in tuples
+                using buffer_infos_ptr_t = std::tuple<std::remove_reference_t<decltype(buffer_infos)>*...>;
+                using memory_t           = std::tuple<buffer_memory<Archs>*...>;
+                buffer_infos_ptr_t buffer_info_tuple{&buffer_infos...};
+                memory_t memory_tuple{&(std::get<buffer_memory<Archs>>(m_mem))...};
+                // loop over buffer_infos/memory and compute required space
+                int i = 0;
+                detail::for_each(memory_tuple, buffer_info_tuple, [this,&i,&tag_offsets](auto mem, auto bi)
+                {
+                    using arch_type  = typename std::remove_reference_t<decltype(*mem)>::arch_type;
+                    using value_type = typename std::remove_reference_t<decltype(*bi)>::value_type;
+                    auto field_ptr = &(bi->get_field());
+                    const domain_id_type my_dom_id = bi->get_field().domain_id();
+                    allocate<arch_type,value_type>(mem, bi->get_pattern(), field_ptr, my_dom_id, bi->device_id(), tag_offsets[i]);
+                    ++i;
+                });
+                handle_type h([this](){ this->wait(); });
+                post_recvs();
+                pack();
+                return h;
+            }
+
+        private: // implementation
+            void post_recvs()
+            {
+                detail::for_each(m_mem, [this](auto& m)
+                {
+                    using hook_future_type = typename std::remove_reference_t<decltype(m)>::hook_future_type;
+                    for (auto& p0 : m.recv_memory)
+                    {
+                        for (auto& p1: p0.second)
+                        {
+                            if (p1.second.size > 0u)
+                            {
+                                // receive directly into field memory if possible
+                                if (p1.second.zero_copy_ptr)
+                                {
+                                    tl::cb::ref_message<unsigned char> msg{p1.second.zero_copy_ptr, p1.second.size};
+                                    m.m_recv_futures.emplace_back(hook_future_type{
+                                        &p1.second, m_comm.recv(msg, p1.second.address, p1.second.tag).m_handle});
+                                    continue;
+                                }
+                                p1.second.buffer.resize(p1.second.size);
+                                m.m_recv_futures.emplace_back(hook_future_type{
+                                    &p1.second, m_comm.recv(p1.second.buffer, p1.second.address, p1.second.tag).m_handle});
+                            }
+                        }
+                    }
+                });
+            }
+
+            void pack()
+            {
+                detail::for_each(m_mem, [this](auto& m)
+                {
+                    using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
+                    packer<arch_type>::pack(m,m_send_futures,m_comm);
+                });
+            }
+
+            /** @brief wait function: only the halos which were received into a buffer are unpacked */
+            void wait()
+            {
+                if (!m_valid) return;
+                detail::for_each(m_mem, [](auto& m)
+                {
+                    using arch_type = typename std::remove_reference_t<decltype(m)>::arch_type;
+                    using hook_type = typename std::remove_reference_t<decltype(m)>::hook_type;
+                    await_futures(m.m_recv_futures, [](hook_type hook)
+                    {
+                        if (!hook->zero_copy_ptr) packer<arch_type>::unpack(*hook, hook->buffer.data());
+                    });
+                });
+                await_requests(m_send_futures);
+#ifdef __CUDACC__
+                // wait for the unpack kernels to finish
+                auto& m = std::get<buffer_memory<gpu>>(m_mem);
+                for (auto& p0 : m.recv_memory)
+                    for (auto& p1: p0.second)
+                        if (p1.second.size > 0u)
+                            p1.second.m_cuda_stream.sync();
+#endif
+                clear();
+            }
+
+            /** @brief clear the internal flags so that a new exchange can be started.
+              * Important: does not deallocate. */
+            void clear()
+            {
+                m_valid = false;
+                m_send_futures.clear();
+                detail::for_each(m_mem, [](auto& m)
+                {
+                    m.m_recv_futures.clear();
+                    for (auto& p0 : m.send_memory)
+                        for (auto& p1 : p0.second)
+                        {
+                            p1.second.buffer.resize(0);
+                            p1.second.size = 0;
+                            p1.second.field_infos.resize(0);
+                            p1.second.zero_copy_ptr = nullptr;
+                        }
+                    for (auto& p0 : m.recv_memory)
+                        for (auto& p1 : p0.second)
+                        {
+                            p1.second.buffer.resize(0);
+                            p1.second.size = 0;
+                            p1.second.field_infos.resize(0);
+                            p1.second.zero_copy_ptr = nullptr;
+                        }
+                });
+            }
+
+        private: // allocation member functions
+            template<typename Arch, typename T, typename Memory, typename Field, typename O>
+            void allocate(Memory mem, const pattern_type& pattern, Field* field_ptr, domain_id_type dom_id,
+                          typename arch_traits<Arch>::device_id_type device_id, O tag_offset)
+            {
+                auto& pool = mem->m_pools[device_id];
+                if (!pool)
+                {
+                    pool.reset( new typename arch_traits<Arch>::pool_type{ typename arch_traits<Arch>::basic_allocator_type{} } );
+                }
+                allocate<Arch,T,typename buffer_memory<Arch>::recv_buffer_type>(
+                    mem->recv_memory[device_id],
+                    pattern.recv_halos(),
+                    [field_ptr](const void* buffer, const index_container_type& c, void* arg)
+                    {
+                        field_ptr->unpack(reinterpret_cast<const T*>(buffer),c,arg);
+                    },
+                    dom_id,
+                    device_id,
+                    tag_offset,
+                    true,
+                    *pool,
+                    field_ptr);
+                allocate<Arch,T,typename buffer_memory<Arch>::send_buffer_type>(
+                    mem->send_memory[device_id],
+                    pattern.send_halos(),
+                    [field_ptr](void* buffer, const index_container_type& c, void* arg)
+                    {
+                        field_ptr->pack(reinterpret_cast<T*>(buffer),c,arg);
+                    },
+                    dom_id,
+                    device_id,
+                    tag_offset,
+                    false,
+                    *pool,
+                    field_ptr);
+            }
+
+            // compute memory requirements and decide whether the halo can bypass the buffer
+            template<typename Arch, typename ValueType, typename BufferType, typename Memory, typename Halos,
+                typename Function, typename DeviceIdType, typename Pool, typename Field>
+            void allocate(Memory& memory, const Halos& halos, Function&& func, domain_id_type my_dom_id,
+                          DeviceIdType device_id, int tag_offset, bool receive, Pool& pool, Field* field_ptr)
+            {
+                for (const auto& p_id_c : halos)
+                {
+                    const auto num_elements = pattern_type::num_elements(p_id_c.second)*
+                        field_ptr->num_components();
+                    if (num_elements < 1) continue;
+                    const auto remote_address = p_id_c.first.address;
+                    const auto remote_dom_id  = p_id_c.first.id;
+                    const auto tag            = p_id_c.first.tag+tag_offset;
+                    const auto d_p_t = receive ?
+                        domain_id_pair_and_tag{my_dom_id, remote_dom_id, tag} :
+                        domain_id_pair_and_tag{remote_dom_id, my_dom_id, tag};
+                    auto it = memory.find(d_p_t);
+                    if (it == memory.end())
+                    {
+                        it = memory.insert(std::make_pair(
+                            d_p_t,
+                            BufferType{
+                                remote_address,
+                                tag,
+                                arch_traits<Arch>::make_message(pool, device_id),
+                                0,
+                                std::vector<typename BufferType::field_info_type>(),
+                                cuda::stream()
+                            })).first;
+                    }
+                    else if (it->second.size==0)
+                    {
+                        it->second.address = remote_address;
+                        it->second.tag = tag;
+                        it->second.field_infos.resize(0);
+                    }
+                    const auto prev_size = it->second.size;
+                    const auto padding = ((prev_size+alignof(ValueType)-1)/alignof(ValueType))*alignof(ValueType) - prev_size;
+                    it->second.field_infos.push_back(
+                        typename BufferType::field_info_type{std::forward<Function>(func), &p_id_c.second, prev_size + padding, field_ptr});
+                    it->second.size += padding + static_cast<std::size_t>(num_elements)*sizeof(ValueType);
+                    // a message holding a single contiguous region of host memory is sent/received in place
+                    it->second.zero_copy_ptr = (std::is_same<Arch,cpu>::value && it->second.field_infos.size() == 1u) ?
+                        detail::contiguous_ptr(field_ptr, p_id_c.second, 0) : nullptr;
+                }
+            }
+        };
+
+        namespace detail {
+
+            /** @brief creates a communication object (struct with implementation)*/
+            template<typename Communicator, typename A, typename DomainIdType>
+            struct make_communication_object_ipr_impl<Communicator, structured::detail::grid<A>, DomainIdType>
+            {
+                using communicator_type = Communicator;
+                using grid_type         = structured::detail::grid<A>;
+                using domain_id_type    = DomainIdType;
+
+                static auto apply(communicator_type comm)
+                {
+                    return communication_object_ipr<communicator_type, grid_type, domain_id_type>{comm};
+                }
+            };
+
+        } // namespace detail
+
+    } // namespace ghex
+
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_COMMUNICATION_OBJECT_IPR_HPP */
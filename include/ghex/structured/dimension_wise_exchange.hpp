@@ -0,0 +1,179 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_DIMENSION_WISE_EXCHANGE_HPP
+#define INCLUDED_GHEX_STRUCTURED_DIMENSION_WISE_EXCHANGE_HPP
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "./pattern.hpp"
+#include "../communication_object_2.hpp"
+
+namespace gridtools {
+    namespace ghex {
+    namespace structured {
+
+    /** @brief splits the patterns into one pattern per dimension for a dimension-by-dimension exchange. The
+     * pattern of dimension d holds the face halos in direction d, extended in the dimensions before d by the halo
+     * widths, such that edge and corner values are forwarded by the face neighbors from the halos received in the
+     * previous phases. In 3D, this replaces the messages to up to 26 neighbors by messages to 6 face neighbors in
+     * three phases. Every face halo must be received from domains which cover the receiving domain in the
+     * extended dimensions, which holds for Cartesian decompositions. The patterns are derived locally, without
+     * communication.
+     * @tparam PatternContainer pattern container type (structured grid)
+     * @tparam HaloGenerator halo generator type providing the halo widths and the periodicity
+     * @param pc patterns (must contain the face halos)
+     * @param hgen the halo generator used to construct the patterns
+     * @return one pattern container per dimension */
+    template<typename PatternContainer, typename HaloGenerator>
+    std::vector<PatternContainer> make_dimension_wise_pattern(const PatternContainer& pc, const HaloGenerator& hgen)
+    {
+        using pattern_type    = typename PatternContainer::value_type;
+        using coordinate_type = typename pattern_type::coordinate_type;
+        using map_type        = typename pattern_type::map_type;
+        using ::gridtools::ghex::detail::relative_first;
+        static constexpr int dim = coordinate_type::size();
+        const auto& halos = hgen.halos();
+        const auto& periodic = hgen.periodic();
+
+        std::vector<PatternContainer> phases(dim, pc);
+        for (int d=0; d<dim; ++d)
+        {
+            for (int i=0; i<pc.size(); ++i)
+            {
+                const auto& p = pc[i];
+                const coordinate_type global_extents = p.global_last() - p.global_first() + 1;
+                // select the face halos in direction d and extend them relative to the receiving domain
+                auto phase_spaces = [&](const auto& spaces, const auto& recv_domain)
+                {
+                    const coordinate_type extents = recv_domain.last() - recv_domain.first() + 1;
+                    std::decay_t<decltype(spaces)> res;
+                    for (auto is : spaces)
+                    {
+                        coordinate_type first, length;
+                        bool face = true;
+                        for (int e=0; e<dim; ++e)
+                        {
+                            first[e] = relative_first(is.global(), recv_domain, e, global_extents[e]);
+                            length[e] = is.global().last()[e] - is.global().first()[e];
+                            const bool outside = first[e] > extents[e]-1 || first[e]+length[e] < 0;
+                            if (outside != (e == d)) face = false;
+                        }
+                        if (!face) continue;
+                        for (int e=0; e<d; ++e)
+                        {
+                            if (first[e] != 0 || length[e] != extents[e]-1)
+                                throw std::runtime_error("dimension-wise exchange: domains are not aligned");
+                            int lo = -halos[2*e];
+                            int hi = extents[e]-1+halos[2*e+1];
+                            if (!periodic[e] && recv_domain.first()[e] == p.global_first()[e]) lo = 0;
+                            if (!periodic[e] && recv_domain.last()[e] == p.global_last()[e]) hi = extents[e]-1;
+                            is.global().first()[e] += lo;
+                            is.global().last()[e]  += hi-extents[e]+1;
+                            is.local().first()[e]  += lo;
+                            is.local().last()[e]   += hi-extents[e]+1;
+                        }
+                        res.push_back(is);
+                    }
+                    return res;
+                };
+
+                auto& q = phases[d][i];
+                map_type recv_map;
+                for (const auto& id_is_pair : p.recv_halos())
+                {
+                    auto spaces = phase_spaces(id_is_pair.second, p.global_domain());
+                    if (!spaces.empty()) recv_map[id_is_pair.first] = std::move(spaces);
+                }
+                map_type send_map;
+                for (const auto& id_is_pair : p.send_halos())
+                {
+                    auto it = p.neighbor_domains().find(id_is_pair.first.id);
+                    if (it == p.neighbor_domains().end())
+                        throw std::runtime_error("dimension-wise exchange: neighbor domain not found");
+                    auto spaces = phase_spaces(id_is_pair.second, it->second);
+                    if (!spaces.empty()) send_map[id_is_pair.first] = std::move(spaces);
+                }
+                q.recv_halos() = std::move(recv_map);
+                q.send_halos() = std::move(send_map);
+            }
+        }
+        return phases;
+    }
+
+    /** @brief communication object which exchanges the halos dimension by dimension: the face halos of the first
+     * dimension are exchanged first, then the face halos of the second dimension extended by the halos of the
+     * first one, and so on (see make_dimension_wise_pattern). Each phase completes before the next one starts.
+     * @tparam PatternContainer pattern container type (structured grid) */
+    template<typename PatternContainer>
+    class dimension_wise_communication_object
+    {
+    public: // member types
+        using pattern_container_type    = PatternContainer;
+        using communicator_type         = typename PatternContainer::value_type::communicator_type;
+        using communication_object_type = decltype(make_communication_object<PatternContainer>(
+                                              std::declval<communicator_type>()));
+
+    private: // members
+        std::vector<pattern_container_type> m_phases;
+        communication_object_type m_co;
+
+    public: // ctors
+        /** @brief construct from patterns
+         * @tparam HaloGenerator halo generator type providing the halo widths and the periodicity
+         * @param pc patterns (must contain the face halos)
+         * @param hgen the halo generator used to construct the patterns
+         * @param comm communicator */
+        template<typename HaloGenerator>
+        dimension_wise_communication_object(const pattern_container_type& pc, const HaloGenerator& hgen,
+            communicator_type comm)
+        : m_phases(make_dimension_wise_pattern(pc, hgen))
+        , m_co(make_communication_object<pattern_container_type>(comm))
+        {}
+
+        dimension_wise_communication_object(const dimension_wise_communication_object&) = delete;
+        dimension_wise_communication_object(dimension_wise_communication_object&&) = default;
+
+    public: // member functions
+        /** @brief patterns of the phases (one per dimension) */
+        const std::vector<pattern_container_type>& phases() const noexcept { return m_phases; }
+
+        /** @brief exchange the halos of the fields (blocking)
+         * @tparam Fields field types
+         * @param fields fields (one field per domain) */
+        template<typename... Fields>
+        void exchange(Fields&... fields)
+        {
+            for (const auto& phase : m_phases)
+                m_co.exchange(phase(fields)...).wait();
+        }
+    };
+
+    /** @brief creates a communication object which exchanges the halos dimension by dimension
+     * @tparam PatternContainer pattern container type (structured grid)
+     * @tparam HaloGenerator halo generator type providing the halo widths and the periodicity
+     * @param pc patterns (must contain the face halos)
+     * @param hgen the halo generator used to construct the patterns
+     * @param comm communicator
+     * @return communication object */
+    template<typename PatternContainer, typename HaloGenerator>
+    dimension_wise_communication_object<PatternContainer> make_dimension_wise_communication_object(
+        const PatternContainer& pc, const HaloGenerator& hgen,
+        typename PatternContainer::value_type::communicator_type comm)
+    {
+        return {pc, hgen, comm};
+    }
+
+    } // namespace structured
+    } // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_DIMENSION_WISE_EXCHANGE_HPP */
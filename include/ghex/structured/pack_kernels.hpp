@@ -11,11 +11,22 @@
 #ifndef INCLUDED_GHEX_STRUCTURED_PACK_KERNELS_HPP
 #define INCLUDED_GHEX_STRUCTURED_PACK_KERNELS_HPP
 
+#include <algorithm>
 #include <cstring>
+#include <cstdint>
+#include <limits>
 #include "./field_utils.hpp"
+#include "./static_halos.hpp"
 #include "../common/utils.hpp"
+#include "../common/streaming_stores.hpp"
 #include "../arch_traits.hpp"
 
+#if !defined(GHEX_NO_SIMD_PACK_KERNELS) && !defined(__CUDACC__) && \
+    (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GHEX_SIMD_PACK_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace gridtools {
 namespace ghex {
 namespace structured {
@@ -29,6 +40,509 @@ struct reduced_layout_map<Idx, std::index_sequence<Ms...>, LMap>{
     using type = gridtools::layout_map<LMap::at(Ms<Idx ? Ms : Ms+1)...>;
 };
 
+/** @brief host kernels which copy blocks of short rows between strided field memory and contiguous buffers.
+  * Rows of 4, 8 and 16 bytes (e.g. float, int and double values, or rows of 2 doubles and 4 floats) are copied
+  * with AVX2/AVX-512 gather and AVX-512 scatter instructions when supported by the CPU (runtime detection), other
+  * row sizes use fixed size copies. Define GHEX_NO_SIMD_PACK_KERNELS to disable the vector kernels. */
+namespace cpu_kernels {
+
+/** @brief instruction sets of the kernels */
+enum class isa { scalar, avx2, avx512 };
+
+/** @brief best instruction set supported by the host cpu */
+inline isa detect_isa() noexcept {
+#ifdef GHEX_SIMD_PACK_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return isa::avx512;
+    if (__builtin_cpu_supports("avx2")) return isa::avx2;
+#endif
+    return isa::scalar;
+}
+
+/** @brief instruction set used by the kernels, initialized by detect_isa(). May be lowered, e.g. for testing. */
+inline isa& selected_isa() noexcept {
+    static isa i = detect_isa();
+    return i;
+}
+
+namespace detail {
+template<std::size_t N>
+inline void gather_rows(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    for (std::size_t i=0; i<num_rows; ++i, src+=stride, dst+=N) std::memcpy(dst, src, N);
+}
+
+template<std::size_t N>
+inline void scatter_rows(const char* src, char* dst, std::size_t stride, std::size_t num_rows) noexcept {
+    for (std::size_t i=0; i<num_rows; ++i, src+=N, dst+=stride) std::memcpy(dst, src, N);
+}
+
+inline void gather_rows(const char* src, std::size_t stride, char* dst, std::size_t row_bytes,
+    std::size_t num_rows) noexcept {
+    for (std::size_t i=0; i<num_rows; ++i, src+=stride, dst+=row_bytes) std::memcpy(dst, src, row_bytes);
+}
+
+inline void scatter_rows(const char* src, char* dst, std::size_t stride, std::size_t row_bytes,
+    std::size_t num_rows) noexcept {
+    for (std::size_t i=0; i<num_rows; ++i, src+=row_bytes, dst+=stride) std::memcpy(dst, src, row_bytes);
+}
+
+#ifdef GHEX_SIMD_PACK_KERNELS
+// 32 bit gathers use 32 bit byte offsets
+static constexpr std::size_t max_stride_32 = std::numeric_limits<std::int32_t>::max()/16;
+
+__attribute__((target("avx2")))
+inline void gather_rows_4_avx2(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    const __m256i idx = _mm256_mullo_epi32(_mm256_setr_epi32(0,1,2,3,4,5,6,7),
+        _mm256_set1_epi32(static_cast<int>(stride)));
+    std::size_t i = 0;
+    for (; i+8<=num_rows; i+=8, src+=8*stride, dst+=32)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+            _mm256_i32gather_epi32(reinterpret_cast<const int*>(src), idx, 1));
+    gather_rows<4>(src, stride, dst, num_rows-i);
+}
+
+__attribute__((target("avx2")))
+inline void gather_rows_8_avx2(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    const long long s = static_cast<long long>(stride);
+    const __m256i idx = _mm256_setr_epi64x(0, s, 2*s, 3*s);
+    std::size_t i = 0;
+    for (; i+4<=num_rows; i+=4, src+=4*stride, dst+=32)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+            _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), idx, 1));
+    gather_rows<8>(src, stride, dst, num_rows-i);
+}
+
+// 16 byte rows are gathered as pairs of 8 byte lanes
+__attribute__((target("avx2")))
+inline void gather_rows_16_avx2(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    const long long s = static_cast<long long>(stride);
+    const __m256i idx = _mm256_setr_epi64x(0, 8, s, s+8);
+    std::size_t i = 0;
+    for (; i+2<=num_rows; i+=2, src+=2*stride, dst+=32)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+            _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), idx, 1));
+    gather_rows<16>(src, stride, dst, num_rows-i);
+}
+
+__attribute__((target("avx512f")))
+inline void gather_rows_4_avx512(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    const __m512i idx = _mm512_mullo_epi32(_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),
+        _mm512_set1_epi32(static_cast<int>(stride)));
+    std::size_t i = 0;
+    for (; i+16<=num_rows; i+=16, src+=16*stride, dst+=64)
+        _mm512_storeu_si512(dst, _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xffff, idx, src, 1));
+    gather_rows<4>(src, stride, dst, num_rows-i);
+}
+
+__attribute__((target("avx512f")))
+inline void gather_rows_8_avx512(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    const long long s = static_cast<long long>(stride);
+    const __m512i idx = _mm512_set_epi64(7*s, 6*s, 5*s, 4*s, 3*s, 2*s, s, 0);
+    std::size_t i = 0;
+    for (; i+8<=num_rows; i+=8, src+=8*stride, dst+=64)
+        _mm512_storeu_si512(dst, _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xff, idx, src, 1));
+    gather_rows<8>(src, stride, dst, num_rows-i);
+}
+
+// one 16 byte row per 128 bit lane
+__attribute__((target("avx512f")))
+inline void gather_rows_16_avx512(const char* src, std::size_t stride, char* dst, std::size_t num_rows) noexcept {
+    const long long s = static_cast<long long>(stride);
+    const __m512i idx = _mm512_set_epi64(3*s+8, 3*s, 2*s+8, 2*s, s+8, s, 8, 0);
+    std::size_t i = 0;
+    for (; i+4<=num_rows; i+=4, src+=4*stride, dst+=64)
+        _mm512_storeu_si512(dst, _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xff, idx, src, 1));
+    gather_rows<16>(src, stride, dst, num_rows-i);
+}
+
+__attribute__((target("avx512f")))
+inline void scatter_rows_4_avx512(const char* src, char* dst, std::size_t stride, std::size_t num_rows) noexcept {
+    const __m512i idx = _mm512_mullo_epi32(_mm512_setr_epi32(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),
+        _mm512_set1_epi32(static_cast<int>(stride)));
+    std::size_t i = 0;
+    for (; i+16<=num_rows; i+=16, src+=64, dst+=16*stride)
+        _mm512_i32scatter_epi32(dst, idx, _mm512_loadu_si512(src), 1);
+    scatter_rows<4>(src, dst, stride, num_rows-i);
+}
+
+__attribute__((target("avx512f")))
+inline void scatter_rows_8_avx512(const char* src, char* dst, std::size_t stride, std::size_t num_rows) noexcept {
+    const long long s = static_cast<long long>(stride);
+    const __m512i idx = _mm512_set_epi64(7*s, 6*s, 5*s, 4*s, 3*s, 2*s, s, 0);
+    std::size_t i = 0;
+    for (; i+8<=num_rows; i+=8, src+=64, dst+=8*stride)
+        _mm512_i64scatter_epi64(dst, idx, _mm512_loadu_si512(src), 1);
+    scatter_rows<8>(src, dst, stride, num_rows-i);
+}
+
+__attribute__((target("avx512f")))
+inline void scatter_rows_16_avx512(const char* src, char* dst, std::size_t stride, std::size_t num_rows) noexcept {
+    const long long s = static_cast<long long>(stride);
+    const __m512i idx = _mm512_set_epi64(3*s+8, 3*s, 2*s+8, 2*s, s+8, s, 8, 0);
+    std::size_t i = 0;
+    for (; i+4<=num_rows; i+=4, src+=64, dst+=4*stride)
+        _mm512_i64scatter_epi64(dst, idx, _mm512_loadu_si512(src), 1);
+    scatter_rows<16>(src, dst, stride, num_rows-i);
+}
+#endif
+} // namespace detail
+
+/** @brief copy rows from strided memory into contiguous memory
+  * @param src address of the first source row
+  * @param stride distance between source rows in bytes
+  * @param dst contiguous destination memory
+  * @param row_bytes size of a row in bytes
+  * @param num_rows number of rows
+  * @param level instruction set */
+inline void gather(const void* src, std::size_t stride, void* dst, std::size_t row_bytes, std::size_t num_rows,
+    isa level = selected_isa()) noexcept {
+    const char* s = static_cast<const char*>(src);
+    char* d = static_cast<char*>(dst);
+    if (stride == row_bytes || num_rows == 1u) {
+        std::memcpy(d, s, row_bytes*num_rows);
+        return;
+    }
+    switch (row_bytes) {
+        case 4:
+#ifdef GHEX_SIMD_PACK_KERNELS
+            if (stride <= detail::max_stride_32) {
+                if (level == isa::avx512) return detail::gather_rows_4_avx512(s, stride, d, num_rows);
+                if (level == isa::avx2) return detail::gather_rows_4_avx2(s, stride, d, num_rows);
+            }
+#endif
+            return detail::gather_rows<4>(s, stride, d, num_rows);
+        case 8:
+#ifdef GHEX_SIMD_PACK_KERNELS
+            if (level == isa::avx512) return detail::gather_rows_8_avx512(s, stride, d, num_rows);
+            if (level == isa::avx2) return detail::gather_rows_8_avx2(s, stride, d, num_rows);
+#endif
+            return detail::gather_rows<8>(s, stride, d, num_rows);
+        case 12: return detail::gather_rows<12>(s, stride, d, num_rows);
+        case 16:
+#ifdef GHEX_SIMD_PACK_KERNELS
+            if (level == isa::avx512) return detail::gather_rows_16_avx512(s, stride, d, num_rows);
+            if (level == isa::avx2) return detail::gather_rows_16_avx2(s, stride, d, num_rows);
+#endif
+            return detail::gather_rows<16>(s, stride, d, num_rows);
+        case 24: return detail::gather_rows<24>(s, stride, d, num_rows);
+        default: return detail::gather_rows(s, stride, d, row_bytes, num_rows);
+    }
+    (void)level;
+}
+
+/** @brief copy rows from contiguous memory into strided memory
+  * @param src contiguous source memory
+  * @param dst address of the first destination row
+  * @param stride distance between destination rows in bytes
+  * @param row_bytes size of a row in bytes
+  * @param num_rows number of rows
+  * @param level instruction set */
+inline void scatter(const void* src, void* dst, std::size_t stride, std::size_t row_bytes, std::size_t num_rows,
+    isa level = selected_isa()) noexcept {
+    const char* s = static_cast<const char*>(src);
+    char* d = static_cast<char*>(dst);
+    if (stride == row_bytes || num_rows == 1u) {
+        std::memcpy(d, s, row_bytes*num_rows);
+        return;
+    }
+    // AVX2 has no scatter instructions: the fixed size copies are used instead
+    switch (row_bytes) {
+        case 4:
+#ifdef GHEX_SIMD_PACK_KERNELS
+            if (stride <= detail::max_stride_32 && level == isa::avx512)
+                return detail::scatter_rows_4_avx512(s, d, stride, num_rows);
+#endif
+            return detail::scatter_rows<4>(s, d, stride, num_rows);
+        case 8:
+#ifdef GHEX_SIMD_PACK_KERNELS
+            if (level == isa::avx512) return detail::scatter_rows_8_avx512(s, d, stride, num_rows);
+#endif
+            return detail::scatter_rows<8>(s, d, stride, num_rows);
+        case 12: return detail::scatter_rows<12>(s, d, stride, num_rows);
+        case 16:
+#ifdef GHEX_SIMD_PACK_KERNELS
+            if (level == isa::avx512) return detail::scatter_rows_16_avx512(s, d, stride, num_rows);
+#endif
+            return detail::scatter_rows<16>(s, d, stride, num_rows);
+        case 24: return detail::scatter_rows<24>(s, d, stride, num_rows);
+        default: return detail::scatter_rows(s, d, stride, row_bytes, num_rows);
+    }
+    (void)level;
+}
+
+/** @brief kernels used for a block of rows (see gather_static) */
+enum class kernel {
+    generic,      ///< row length and number of rows are runtime values
+    static_rows,  ///< row length is a static halo width
+    static_block, ///< number of rows is a static halo width (the row length is a runtime value)
+    static_tile   ///< row length and number of rows are static halo widths
+};
+
+namespace detail {
+// copy a constant number of rows of runtime length
+template<std::size_t M>
+inline void gather_block(const char* src, std::size_t stride, char* dst, std::size_t row_bytes) noexcept {
+    for (std::size_t i=0; i<M; ++i) std::memcpy(dst+i*row_bytes, src+i*stride, row_bytes);
+}
+
+template<std::size_t M>
+inline void scatter_block(const char* src, char* dst, std::size_t stride, std::size_t row_bytes) noexcept {
+    for (std::size_t i=0; i<M; ++i) std::memcpy(dst+i*stride, src+i*row_bytes, row_bytes);
+}
+
+// copy a constant number of rows of constant length
+template<std::size_t N, std::size_t M>
+inline void gather_tile(const char* src, std::size_t stride, char* dst) noexcept {
+    for (std::size_t i=0; i<M; ++i) std::memcpy(dst+i*N, src+i*stride, N);
+}
+
+template<std::size_t N, std::size_t M>
+inline void scatter_tile(const char* src, char* dst, std::size_t stride) noexcept {
+    for (std::size_t i=0; i<M; ++i) std::memcpy(dst+i*stride, src+i*N, N);
+}
+
+// selects the kernel whose number of rows equals one of the widths Ws. N is the row length in bytes if it is a
+// compile-time constant, and 0 otherwise.
+template<std::size_t N, typename Ws>
+struct block_dispatch;
+
+template<std::size_t N>
+struct block_dispatch<N, std::integer_sequence<int>> {
+    static kernel gather(const char*, std::size_t, char*, std::size_t, std::size_t) noexcept {
+        return kernel::generic;
+    }
+    static kernel scatter(const char*, char*, std::size_t, std::size_t, std::size_t) noexcept {
+        return kernel::generic;
+    }
+};
+
+// zero widths (no halo) are skipped
+template<std::size_t N, int... Ws>
+struct block_dispatch<N, std::integer_sequence<int, 0, Ws...>>
+: public block_dispatch<N, std::integer_sequence<int, Ws...>> {};
+
+template<std::size_t N, int W, int... Ws>
+struct block_dispatch<N, std::integer_sequence<int, W, Ws...>> {
+    using next = block_dispatch<N, std::integer_sequence<int, Ws...>>;
+
+    static kernel gather(const char* src, std::size_t stride, char* dst, std::size_t row_bytes,
+        std::size_t num_rows) noexcept {
+        if (num_rows != W) return next::gather(src, stride, dst, row_bytes, num_rows);
+        return gather(src, stride, dst, row_bytes, std::integral_constant<bool, (N>0)>{});
+    }
+
+    static kernel scatter(const char* src, char* dst, std::size_t stride, std::size_t row_bytes,
+        std::size_t num_rows) noexcept {
+        if (num_rows != W) return next::scatter(src, dst, stride, row_bytes, num_rows);
+        return scatter(src, dst, stride, row_bytes, std::integral_constant<bool, (N>0)>{});
+    }
+
+private:
+    static kernel gather(const char* src, std::size_t stride, char* dst, std::size_t, std::true_type) noexcept {
+        gather_tile<N,W>(src, stride, dst);
+        return kernel::static_tile;
+    }
+    static kernel gather(const char* src, std::size_t stride, char* dst, std::size_t row_bytes,
+        std::false_type) noexcept {
+        gather_block<W>(src, stride, dst, row_bytes);
+        return kernel::static_block;
+    }
+    static kernel scatter(const char* src, char* dst, std::size_t stride, std::size_t, std::true_type) noexcept {
+        scatter_tile<N,W>(src, dst, stride);
+        return kernel::static_tile;
+    }
+    static kernel scatter(const char* src, char* dst, std::size_t stride, std::size_t row_bytes,
+        std::false_type) noexcept {
+        scatter_block<W>(src, dst, stride, row_bytes);
+        return kernel::static_block;
+    }
+};
+
+// selects the kernel whose row length equals one of the widths RowWs, or whose number of rows equals one of
+// the widths BlockWs
+template<typename T, typename RowWs, typename BlockWs>
+struct static_dispatch;
+
+template<typename T, typename BlockWs>
+struct static_dispatch<T, std::integer_sequence<int>, BlockWs> {
+    static kernel gather(const char* src, std::size_t stride, char* dst, std::size_t row_elements,
+        std::size_t num_rows) noexcept {
+        return block_dispatch<0, BlockWs>::gather(src, stride, dst, row_elements*sizeof(T), num_rows);
+    }
+    static kernel scatter(const char* src, char* dst, std::size_t stride, std::size_t row_elements,
+        std::size_t num_rows) noexcept {
+        return block_dispatch<0, BlockWs>::scatter(src, dst, stride, row_elements*sizeof(T), num_rows);
+    }
+};
+
+template<typename T, int... Ws, typename BlockWs>
+struct static_dispatch<T, std::integer_sequence<int, 0, Ws...>, BlockWs>
+: public static_dispatch<T, std::integer_sequence<int, Ws...>, BlockWs> {};
+
+template<typename T, int W, int... Ws, typename BlockWs>
+struct static_dispatch<T, std::integer_sequence<int, W, Ws...>, BlockWs> {
+    using next = static_dispatch<T, std::integer_sequence<int, Ws...>, BlockWs>;
+    static constexpr std::size_t N = W*sizeof(T);
+    // long runs of 4, 8 and 16 byte rows are left to the vector kernels
+    static constexpr bool vector_rows = (N == 4u || N == 8u || N == 16u);
+
+    static kernel gather(const char* src, std::size_t stride, char* dst, std::size_t row_elements,
+        std::size_t num_rows) noexcept {
+        if (row_elements != W) return next::gather(src, stride, dst, row_elements, num_rows);
+        const auto k = block_dispatch<N, BlockWs>::gather(src, stride, dst, N, num_rows);
+        if (k != kernel::generic) return k;
+        if (vector_rows) return kernel::generic;
+        gather_rows<N>(src, stride, dst, num_rows);
+        return kernel::static_rows;
+    }
+
+    static kernel scatter(const char* src, char* dst, std::size_t stride, std::size_t row_elements,
+        std::size_t num_rows) noexcept {
+        if (row_elements != W) return next::scatter(src, dst, stride, row_elements, num_rows);
+        const auto k = block_dispatch<N, BlockWs>::scatter(src, dst, stride, N, num_rows);
+        if (k != kernel::generic) return k;
+        if (vector_rows) return kernel::generic;
+        scatter_rows<N>(src, dst, stride, num_rows);
+        return kernel::static_rows;
+    }
+};
+
+// copy rows with the kernels specialized for the static halo widths, or with the generic kernels
+template<typename RowWs, typename BlockWs, typename T>
+inline kernel gather_static_rows(const T* src, std::size_t stride, T* dst, std::size_t row_elements,
+    std::size_t num_rows) noexcept {
+    const std::size_t row_bytes = row_elements*sizeof(T);
+    kernel k = kernel::generic;
+    if (stride != row_bytes && num_rows != 1u)
+        k = static_dispatch<T, RowWs, BlockWs>::gather(reinterpret_cast<const char*>(src), stride,
+            reinterpret_cast<char*>(dst), row_elements, num_rows);
+    if (k == kernel::generic)
+        ::gridtools::ghex::structured::cpu_kernels::gather(src, stride, dst, row_bytes, num_rows);
+    return k;
+}
+
+template<typename RowWs, typename BlockWs, typename T>
+inline kernel scatter_static_rows(const T* src, T* dst, std::size_t stride, std::size_t row_elements,
+    std::size_t num_rows) noexcept {
+    const std::size_t row_bytes = row_elements*sizeof(T);
+    kernel k = kernel::generic;
+    if (stride != row_bytes && num_rows != 1u)
+        k = static_dispatch<T, RowWs, BlockWs>::scatter(reinterpret_cast<const char*>(src),
+            reinterpret_cast<char*>(dst), stride, row_elements, num_rows);
+    if (k == kernel::generic)
+        ::gridtools::ghex::structured::cpu_kernels::scatter(src, dst, stride, row_bytes, num_rows);
+    return k;
+}
+
+// rows are copied in chunks of this size in streaming mode
+static constexpr std::size_t staging_bytes = 4096;
+} // namespace detail
+
+/** @brief copy rows of values from strided memory into contiguous memory. Rows whose length is one of the widths
+  * RowWidths and blocks whose number of rows is one of the widths BlockWidths are copied by kernels with constant
+  * trip counts (see kernel); all other blocks, and runs of 4, 8 and 16 byte rows, use the kernels of gather. In
+  * streaming mode (see streaming_stores) the rows are gathered in chunks into a cache resident staging area, which
+  * is written to the destination with non-temporal stores.
+  * @tparam RowWidths static halo widths of the contiguous dimension (std::integer_sequence<int,...>)
+  * @tparam BlockWidths static halo widths of the dimension along which the rows are stacked
+  * @param src address of the first source row
+  * @param stride distance between source rows in bytes
+  * @param dst contiguous destination memory
+  * @param row_elements number of values per row
+  * @param num_rows number of rows
+  * @return kernel used for the (last chunk of) rows */
+template<typename RowWidths = std::integer_sequence<int>, typename BlockWidths = std::integer_sequence<int>,
+    typename T>
+inline kernel gather_static(const T* src, std::size_t stride, T* dst, std::size_t row_elements,
+    std::size_t num_rows) noexcept {
+    const std::size_t row_bytes = row_elements*sizeof(T);
+    if (!streaming_stores::active() || row_bytes*num_rows < detail::staging_bytes)
+        return detail::gather_static_rows<RowWidths,BlockWidths>(src, stride, dst, row_elements, num_rows);
+    const char* s = reinterpret_cast<const char*>(src);
+    char* d = reinterpret_cast<char*>(dst);
+    if (stride == row_bytes) {
+        streaming_stores::copy(d, s, row_bytes*num_rows);
+        return kernel::generic;
+    }
+    if (2u*row_bytes > detail::staging_bytes) {
+        // long rows are streamed one by one
+        for (std::size_t i=0; i<num_rows; ++i, s+=stride, d+=row_bytes) streaming_stores::copy(d, s, row_bytes);
+        return kernel::generic;
+    }
+    alignas(64) static thread_local char staging[detail::staging_bytes];
+    const std::size_t chunk = detail::staging_bytes/row_bytes;
+    kernel k = kernel::generic;
+    for (std::size_t i=0; i<num_rows; i+=chunk, s+=chunk*stride, d+=chunk*row_bytes) {
+        const std::size_t m = std::min(chunk, num_rows-i);
+        k = detail::gather_static_rows<RowWidths,BlockWidths>(reinterpret_cast<const T*>(s), stride,
+            reinterpret_cast<T*>(staging), row_elements, m);
+        streaming_stores::copy(d, staging, m*row_bytes);
+    }
+    return k;
+}
+
+/** @brief copy rows of values from contiguous memory into strided memory (see gather_static). In streaming mode
+  * the source is prefetched one chunk ahead.
+  * @tparam RowWidths static halo widths of the contiguous dimension (std::integer_sequence<int,...>)
+  * @tparam BlockWidths static halo widths of the dimension along which the rows are stacked
+  * @param src contiguous source memory
+  * @param dst address of the first destination row
+  * @param stride distance between destination rows in bytes
+  * @param row_elements number of values per row
+  * @param num_rows number of rows
+  * @return kernel used for the (last chunk of) rows */
+template<typename RowWidths = std::integer_sequence<int>, typename BlockWidths = std::integer_sequence<int>,
+    typename T>
+inline kernel scatter_static(const T* src, T* dst, std::size_t stride, std::size_t row_elements,
+    std::size_t num_rows) noexcept {
+    const std::size_t row_bytes = row_elements*sizeof(T);
+    if (!streaming_stores::active() || stride == row_bytes || row_bytes*num_rows < detail::staging_bytes)
+        return detail::scatter_static_rows<RowWidths,BlockWidths>(src, dst, stride, row_elements, num_rows);
+    const char* s = reinterpret_cast<const char*>(src);
+    char* d = reinterpret_cast<char*>(dst);
+    const std::size_t chunk = std::max<std::size_t>(1u, detail::staging_bytes/row_bytes);
+    kernel k = kernel::generic;
+    for (std::size_t i=0; i<num_rows; i+=chunk, s+=chunk*row_bytes, d+=chunk*stride) {
+        const std::size_t m = std::min(chunk, num_rows-i);
+        if (i+m < num_rows)
+            streaming_stores::prefetch(s+m*row_bytes, std::min(chunk, num_rows-i-m)*row_bytes);
+        k = detail::scatter_static_rows<RowWidths,BlockWidths>(reinterpret_cast<const T*>(s),
+            reinterpret_cast<T*>(d), stride, row_elements, m);
+    }
+    return k;
+}
+
+/** @brief copy a 2-dimensional array of values between memory regions with different strides. The copy is done
+  * in square tiles, such that both the source and the destination are accessed in cache-friendly blocks, and the
+  * inner loop runs along dimension 0.
+  * @param src source address of element (0,0)
+  * @param src_stride_0 source byte stride of dimension 0
+  * @param src_stride_1 source byte stride of dimension 1
+  * @param dst destination address of element (0,0)
+  * @param dst_stride_0 destination byte stride of dimension 0
+  * @param dst_stride_1 destination byte stride of dimension 1
+  * @param n_0 extent of dimension 0
+  * @param n_1 extent of dimension 1 */
+template<typename T>
+inline void transpose(const T* src, std::size_t src_stride_0, std::size_t src_stride_1, T* dst,
+    std::size_t dst_stride_0, std::size_t dst_stride_1, std::size_t n_0, std::size_t n_1) noexcept {
+    static constexpr std::size_t tile = 16;
+    const char* s = reinterpret_cast<const char*>(src);
+    char* d = reinterpret_cast<char*>(dst);
+    for (std::size_t j0=0; j0<n_1; j0+=tile) {
+        const std::size_t j1 = std::min(j0+tile, n_1);
+        for (std::size_t i0=0; i0<n_0; i0+=tile) {
+            const std::size_t i1 = std::min(i0+tile, n_0);
+            for (std::size_t j=j0; j<j1; ++j)
+                for (std::size_t i=i0; i<i1; ++i)
+                    *reinterpret_cast<T*>(d + i*dst_stride_0 + j*dst_stride_1) =
+                        *reinterpret_cast<const T*>(s + i*src_stride_0 + j*src_stride_1);
+        }
+    }
+}
+
+} // namespace cpu_kernels
+
 /** @brief Helper class to dispatch to CPU/GPU implementations of pack/unpack kernels
   * @tparam Arch Architecture type
   * @tparam LayoutMap Data layout map*/
@@ -58,73 +572,232 @@ struct serialization {
             unpack_is.m_data_is.m_last);
     }
 
+    /** @brief pack a halo block by block (see for_each_row_block). If the field has static halos, blocks whose
+      * extents match the halo widths are packed by kernels instantiated for these widths.
+      * @tparam StaticHalos static_halos<...> of the field (static_halos<> for runtime halos) */
+    template<typename PackIterationSpace, typename StaticHalos = static_halos<>>
+    static void pack_batch(PackIterationSpace&& pack_is, void*, StaticHalos = {}) {
+        using value_type = typename std::remove_reference_t<PackIterationSpace>::value_t;
+        static constexpr auto D = std::remove_reference_t<PackIterationSpace>::coordinate_t::size();
+        using row_ws = row_widths<StaticHalos, D>;
+        using block_ws = block_widths<StaticHalos, D>;
+        for_each_row_block(pack_is,
+            [](value_type* buffer, const value_type* field, std::size_t stride, std::size_t row_bytes,
+                std::size_t num_rows) {
+                cpu_kernels::gather_static<row_ws,block_ws>(field, stride, buffer, row_bytes/sizeof(value_type),
+                    num_rows);
+            });
+    }
+
+    /** @brief unpack a halo block by block (see pack_batch) */
+    template<typename UnPackIterationSpace, typename StaticHalos = static_halos<>>
+    static void unpack_batch(UnPackIterationSpace&& unpack_is, void*, StaticHalos = {}) {
+        using value_type = typename std::remove_reference_t<UnPackIterationSpace>::value_t;
+        static constexpr auto D = std::remove_reference_t<UnPackIterationSpace>::coordinate_t::size();
+        using row_ws = row_widths<StaticHalos, D>;
+        using block_ws = block_widths<StaticHalos, D>;
+        for_each_row_block(unpack_is,
+            [](const value_type* buffer, value_type* field, std::size_t stride, std::size_t row_bytes,
+                std::size_t num_rows) {
+                cpu_kernels::scatter_static<row_ws,block_ws>(buffer, field, stride, row_bytes/sizeof(value_type),
+                    num_rows);
+            });
+    }
+
+    /** @brief pack several fields in a single traversal of the halo. All fields share the memory layout
+      * described by pack_is: the rows of field k are read at the same byte offsets relative to data(k) and are
+      * written at the same byte offsets relative to buffer(k).
+      * @tparam StaticHalos static_halos<...> of the fields (see pack_batch)
+      * @param pack_is iteration space of the first field
+      * @param n number of fields
+      * @param data functor returning the (const char*) data pointer of field k
+      * @param buffer functor returning the (char*) buffer pointer of field k */
+    template<typename PackIterationSpace, typename Data, typename Buffer, typename StaticHalos = static_halos<>>
+    static void pack_batch_fused(PackIterationSpace&& pack_is, std::size_t n, Data&& data, Buffer&& buffer,
+        StaticHalos = {}) {
+        using value_type = typename std::remove_reference_t<PackIterationSpace>::value_t;
+        static constexpr auto D = std::remove_reference_t<PackIterationSpace>::coordinate_t::size();
+        using row_ws = row_widths<StaticHalos, D>;
+        using block_ws = block_widths<StaticHalos, D>;
+        const char* data_0 = reinterpret_cast<const char*>(pack_is.m_data_is.m_ptr);
+        const char* buffer_0 = reinterpret_cast<const char*>(pack_is.m_buffer_desc.m_ptr);
+        for_each_row_block(pack_is,
+            [n,data_0,buffer_0,&data,&buffer](value_type* b, const value_type* f, std::size_t stride,
+                std::size_t row_bytes, std::size_t num_rows) {
+                const auto f_offset = reinterpret_cast<const char*>(f) - data_0;
+                const auto b_offset = reinterpret_cast<const char*>(b) - buffer_0;
+                for (std::size_t k=0; k<n; ++k)
+                    cpu_kernels::gather_static<row_ws,block_ws>(
+                        reinterpret_cast<const value_type*>(data(k)+f_offset), stride,
+                        reinterpret_cast<value_type*>(buffer(k)+b_offset), row_bytes/sizeof(value_type), num_rows);
+            });
+    }
+
+    /** @brief unpack several fields in a single traversal of the halo (see pack_batch_fused)
+      * @tparam StaticHalos static_halos<...> of the fields (see pack_batch)
+      * @param unpack_is iteration space of the first field
+      * @param n number of fields
+      * @param data functor returning the (char*) data pointer of field k
+      * @param buffer functor returning the (const char*) buffer pointer of field k */
+    template<typename UnPackIterationSpace, typename Data, typename Buffer, typename StaticHalos = static_halos<>>
+    static void unpack_batch_fused(UnPackIterationSpace&& unpack_is, std::size_t n, Data&& data, Buffer&& buffer,
+        StaticHalos = {}) {
+        using value_type = typename std::remove_reference_t<UnPackIterationSpace>::value_t;
+        static constexpr auto D = std::remove_reference_t<UnPackIterationSpace>::coordinate_t::size();
+        using row_ws = row_widths<StaticHalos, D>;
+        using block_ws = block_widths<StaticHalos, D>;
+        const char* data_0 = reinterpret_cast<const char*>(unpack_is.m_data_is.m_ptr);
+        const char* buffer_0 = reinterpret_cast<const char*>(unpack_is.m_buffer_desc.m_ptr);
+        for_each_row_block(unpack_is,
+            [n,data_0,buffer_0,&data,&buffer](const value_type* b, value_type* f, std::size_t stride,
+                std::size_t row_bytes, std::size_t num_rows) {
+                const auto f_offset = reinterpret_cast<const char*>(f) - data_0;
+                const auto b_offset = reinterpret_cast<const char*>(b) - buffer_0;
+                for (std::size_t k=0; k<n; ++k)
+                    cpu_kernels::scatter_static<row_ws,block_ws>(
+                        reinterpret_cast<const value_type*>(buffer(k)+b_offset),
+                        reinterpret_cast<value_type*>(data(k)+f_offset), stride, row_bytes/sizeof(value_type),
+                        num_rows);
+            });
+    }
+
+    /** @brief pack a halo into a buffer whose element order differs from the field's memory layout. The field
+      * memory is traversed in its own order while the fastest varying dimensions of field and buffer are
+      * transposed in tiles. */
     template<typename PackIterationSpace>
-    static void pack_batch(PackIterationSpace&& pack_is, void*) {
-        using coordinate_type = typename PackIterationSpace::coordinate_t;
-        using value_type = typename PackIterationSpace::value_t;
-        constexpr auto D = coordinate_type::size();
-        constexpr auto cont_idx = LayoutMap::find(D-1);
-        const auto x_first = pack_is.m_data_is.m_first[cont_idx];
-        const auto x_last = pack_is.m_data_is.m_last[cont_idx];
-        using LayoutMap2 = typename reduced_layout_map<cont_idx,std::make_index_sequence<D-1>,LayoutMap>::type;
-        using scalar_coord_type = typename std::remove_cv<decltype(x_first)>::type;
-        using cont_coord_type = gridtools::array<scalar_coord_type,D-1>;
-        cont_coord_type first,last;
-        for (std::size_t j=0, i=0; i<D; ++i) {
-            if (i==cont_idx) continue;
-            first[j] = pack_is.m_data_is.m_first[i];
-            last[j++] = pack_is.m_data_is.m_last[i];
-        }
-        ::gridtools::ghex::detail::for_loop<D-1,D-1,LayoutMap2>::template apply(
-            [&pack_is,&x_first,&x_last](auto... xs) {
-                const cont_coord_type x0{xs...};
-                coordinate_type x1;
-                x1[cont_idx] = x_first;
-                for (std::size_t j=0, i=0; i<D; ++i) {
-                    if (i==cont_idx) continue;
-                    x1[i] = x0[j++];
-                }
-                value_type* buffer = &(pack_is.buffer(x1));
-                value_type const * field = &(pack_is.data(x1));
-                std::memcpy(buffer, field, (x_last-x_first+1)*sizeof(value_type));
-            },
-            first,
-            last);
+    static void pack_transposed(PackIterationSpace&& pack_is, void*) {
+        using value_type = typename std::remove_reference_t<PackIterationSpace>::value_t;
+        for_each_transposed_slab(pack_is,
+            [&pack_is](const auto& x, int f, int b, std::size_t n_f, std::size_t n_b) {
+                const auto& d_strides = pack_is.m_data_is.m_strides;
+                const auto& b_strides = pack_is.m_buffer_desc.m_strides;
+                if (f == b)
+                    cpu_kernels::gather_static(&(pack_is.data(x)), 0, &(pack_is.buffer(x)), n_f, 1);
+                else
+                    cpu_kernels::transpose<value_type>(&(pack_is.data(x)), d_strides[f], d_strides[b],
+                        &(pack_is.buffer(x)), b_strides[f], b_strides[b], n_f, n_b);
+            });
     }
 
+    /** @brief unpack a halo from a buffer whose element order differs from the field's memory layout
+      * (see pack_transposed) */
     template<typename UnPackIterationSpace>
-    static void unpack_batch(UnPackIterationSpace&& unpack_is, void*) {
-        using coordinate_type = typename UnPackIterationSpace::coordinate_t;
-        using value_type = typename UnPackIterationSpace::value_t;
+    static void unpack_transposed(UnPackIterationSpace&& unpack_is, void*) {
+        using value_type = typename std::remove_reference_t<UnPackIterationSpace>::value_t;
+        for_each_transposed_slab(unpack_is,
+            [&unpack_is](const auto& x, int f, int b, std::size_t n_f, std::size_t n_b) {
+                const auto& d_strides = unpack_is.m_data_is.m_strides;
+                const auto& b_strides = unpack_is.m_buffer_desc.m_strides;
+                if (f == b)
+                    cpu_kernels::scatter_static(&(unpack_is.buffer(x)), &(unpack_is.data(x)), 0, n_f, 1);
+                else
+                    cpu_kernels::transpose<value_type>(&(unpack_is.buffer(x)), b_strides[f], b_strides[b],
+                        &(unpack_is.data(x)), d_strides[f], d_strides[b], n_f, n_b);
+            });
+    }
+
+    /** @brief static halo widths of the contiguous dimension of a D-dimensional field (rows of a block) */
+    template<typename StaticHalos, std::size_t D>
+    using row_widths = typename structured::detail::static_halo_widths<StaticHalos,
+        (std::size_t)LayoutMap::find(D-1)>::type;
+
+    /** @brief static halo widths of the dimension along which the rows of a block are stacked */
+    template<typename StaticHalos, std::size_t D>
+    using block_widths = typename structured::detail::static_halo_widths<StaticHalos,
+        (std::size_t)LayoutMap::find(D-2)>::type;
+
+private: // implementation
+    // Visits the halo as blocks of rows: a row spans the contiguous dimension and a block spans the next slower
+    // varying dimension. Rows of a block are contiguous in the buffer and separated by a constant stride in the
+    // field, such that they can be copied by a single strided gather/scatter kernel.
+    template<typename IterationSpace, typename Func>
+    static void for_each_row_block(IterationSpace& is, Func&& f) {
+        using coordinate_type = typename std::remove_reference_t<IterationSpace>::coordinate_t;
+        using value_type = typename std::remove_reference_t<IterationSpace>::value_t;
         constexpr auto D = coordinate_type::size();
         constexpr auto cont_idx = LayoutMap::find(D-1);
-        const auto x_first = unpack_is.m_data_is.m_first[cont_idx];
-        const auto x_last = unpack_is.m_data_is.m_last[cont_idx];
+        const auto x_first = is.m_data_is.m_first[cont_idx];
+        const auto x_last = is.m_data_is.m_last[cont_idx];
+        const std::size_t row_bytes = (x_last-x_first+1)*sizeof(value_type);
         using LayoutMap2 = typename reduced_layout_map<cont_idx,std::make_index_sequence<D-1>,LayoutMap>::type;
         using scalar_coord_type = typename std::remove_cv<decltype(x_first)>::type;
         using cont_coord_type = gridtools::array<scalar_coord_type,D-1>;
         cont_coord_type first,last;
         for (std::size_t j=0, i=0; i<D; ++i) {
             if (i==cont_idx) continue;
-            first[j] = unpack_is.m_data_is.m_first[i];
-            last[j++] = unpack_is.m_data_is.m_last[i];
+            first[j] = is.m_data_is.m_first[i];
+            last[j++] = is.m_data_is.m_last[i];
         }
-        ::gridtools::ghex::detail::for_loop<D-1,D-1,LayoutMap2>::template apply(
-            [&unpack_is,&x_first,&x_last](auto... xs) {
-                const cont_coord_type x0{xs...};
-                coordinate_type x1;
-                x1[cont_idx] = x_first;
-                for (std::size_t j=0, i=0; i<D; ++i) {
-                    if (i==cont_idx) continue;
-                    x1[i] = x0[j++];
+        // dimension of the row blocks in the reduced and in the full coordinate system
+        constexpr auto row_idx = LayoutMap2::find(D-2);
+        constexpr auto row_idx_full = row_idx < cont_idx ? row_idx : row_idx+1;
+        const std::size_t num_rows = last[row_idx]-first[row_idx]+1;
+        const std::size_t stride = is.m_data_is.m_strides[row_idx_full];
+        auto block = [&is,&f,x_first,row_bytes,num_rows,stride](const cont_coord_type& x0) {
+            coordinate_type x1;
+            x1[cont_idx] = x_first;
+            for (std::size_t j=0, i=0; i<D; ++i) {
+                if (i==cont_idx) continue;
+                x1[i] = x0[j++];
+            }
+            f(&(is.buffer(x1)), &(is.data(x1)), stride, row_bytes, num_rows);
+        };
+        loop_row_blocks<LayoutMap2>(block, first, last, std::integral_constant<bool,(D>2)>{});
+    }
+
+    // Visits the halo as 2-dimensional slabs spanned by the fastest varying dimension of the field (f) and of the
+    // buffer (b). The remaining dimensions are traversed in the field's order. If f and b coincide, the slabs are
+    // single rows.
+    template<typename IterationSpace, typename Func>
+    static void for_each_transposed_slab(IterationSpace& is, Func&& func) {
+        using coordinate_type = typename std::remove_reference_t<IterationSpace>::coordinate_t;
+        constexpr int D = coordinate_type::size();
+        const auto& first = is.m_data_is.m_first;
+        const auto& last = is.m_data_is.m_last;
+        const auto& b_strides = is.m_buffer_desc.m_strides;
+        const int f = LayoutMap::find(D-1);
+        int b = -1;
+        for (int i=0; i<D; ++i)
+            if (last[i] > first[i] && (b < 0 || b_strides[i] < b_strides[b])) b = i;
+        if (b < 0) b = f;
+        // remaining dimensions from the slowest to the fastest varying one
+        int outer[D];
+        int num_outer = 0;
+        for (int i=0; i<D; ++i) {
+            const int d = LayoutMap::find(i);
+            if (d != f && d != b) outer[num_outer++] = d;
+        }
+        const std::size_t n_f = last[f]-first[f]+1;
+        const std::size_t n_b = last[b]-first[b]+1;
+        coordinate_type x = first;
+        while (true) {
+            func(x, f, b, n_f, n_b);
+            int k = num_outer-1;
+            for (; k>=0; --k) {
+                const int d = outer[k];
+                if (x[d] < last[d]) {
+                    ++x[d];
+                    break;
                 }
-                value_type const * buffer = &(unpack_is.buffer(x1));
-                value_type * field = &(unpack_is.data(x1));
-                std::memcpy(field, buffer, (x_last-x_first+1)*sizeof(value_type));
-            },
+                x[d] = first[d];
+            }
+            if (k < 0) break;
+        }
+    }
+
+    template<typename Layout, typename Func, typename Array>
+    static void loop_row_blocks(Func& f, const Array& first, const Array& last, std::true_type) {
+        constexpr auto D = Array::size();
+        ::gridtools::ghex::detail::for_loop<D,D,Layout,1>::template apply(
+            [&f](auto... xs) { f(Array{xs...}); },
             first,
             last);
     }
+
+    template<typename Layout, typename Func, typename Array>
+    static void loop_row_blocks(Func& f, const Array& first, const Array&, std::false_type) {
+        f(first);
+    }
 };
 
 #ifdef __CUDACC__
@@ -195,13 +868,23 @@ struct serialization<::gridtools::ghex::gpu,LMap> {
         unpack_kernel<LMap><<<num_blocks,block_dim,0,*stream_ptr>>>(unpack_is, elements_per_thread);
     }
     
+    template<typename PackIterationSpace, typename StaticHalos = static_halos<>>
+    static void pack_batch(PackIterationSpace&& pack_is, void* arg, StaticHalos = {}) {
+        pack(std::forward<PackIterationSpace>(pack_is), arg);
+    }
+
     template<typename PackIterationSpace>
-    static void pack_batch(PackIterationSpace&& pack_is, void* arg) {
+    static void pack_transposed(PackIterationSpace&& pack_is, void* arg) {
         pack(std::forward<PackIterationSpace>(pack_is), arg);
     }
 
     template<typename UnPackIterationSpace>
-    static void unpack_batch(UnPackIterationSpace&& unpack_is, void* arg) {
+    static void unpack_transposed(UnPackIterationSpace&& unpack_is, void* arg) {
+        unpack(std::forward<UnPackIterationSpace>(unpack_is), arg);
+    }
+
+    template<typename UnPackIterationSpace, typename StaticHalos = static_halos<>>
+    static void unpack_batch(UnPackIterationSpace&& unpack_is, void* arg, StaticHalos = {}) {
         unpack(std::forward<UnPackIterationSpace>(unpack_is), arg);
     }
 };
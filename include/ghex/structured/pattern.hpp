@@ -11,9 +11,16 @@
 #ifndef INCLUDED_GHEX_STRUCTURED_PATTERN_HPP
 #define INCLUDED_GHEX_STRUCTURED_PATTERN_HPP
 
+#include <algorithm>
 #include <map>
+#include <set>
+#include <vector>
+#include <cstring>
 #include <iosfwd>
 #include "./grid.hpp"
+#include "./box_index.hpp"
+#include "./regular/cartesian_decomposition.hpp"
+#include "./regular/halo_generator.hpp"
 #include "../pattern.hpp"
 #include "../transport_layer/mpi/setup.hpp"
 
@@ -147,6 +154,8 @@ namespace gridtools {
         using index_container_type = std::vector<iteration_space_pair>;
         // halo map type
         using map_type = std::map<extended_domain_id_type, index_container_type>;
+        // extents of the neighbor domains (global coordinates)
+        using domain_map_type = std::map<domain_id_type, iteration_space>;
 
     public: // static member function
         /** @brief compute number of elements in an object of type index_container_type */
@@ -166,6 +175,7 @@ namespace gridtools {
         extended_domain_id_type m_id;
         map_type                m_send_map;
         map_type                m_recv_map;
+        domain_map_type         m_neighbor_domains;
         pattern_container_type* m_container;
 
     public: // ctors
@@ -179,6 +189,8 @@ namespace gridtools {
         const map_type& send_halos() const noexcept { return m_send_map; }
         map_type& recv_halos() noexcept { return m_recv_map; }
         const map_type& recv_halos() const noexcept { return m_recv_map; }
+        domain_map_type& neighbor_domains() noexcept { return m_neighbor_domains; }
+        const domain_map_type& neighbor_domains() const noexcept { return m_neighbor_domains; }
         domain_id_type domain_id() const noexcept { return m_id.id; }
         extended_domain_id_type extended_domain_id() const noexcept { return m_id; }
         const pattern_container_type& container() const noexcept { return *m_container; }
@@ -199,13 +211,170 @@ namespace gridtools {
         }
     };
 
+    namespace structured {
+
+        namespace detail {
+            // true if Field declares no static halo widths or the widths StaticHalos
+            template<typename Field, typename StaticHalos, typename = void>
+            struct has_static_halos : public std::true_type {};
+            template<typename Field, typename StaticHalos>
+            struct has_static_halos<Field, StaticHalos,
+                std::enable_if_t<is_static_halos<typename Field::static_halos_type>::value>>
+            : public std::is_same<typename Field::static_halos_type, StaticHalos> {};
+
+            // static halo widths of a halo generator (void for runtime halos)
+            template<typename HaloGenerator, typename = void>
+            struct generator_static_halos { using type = void; };
+            template<typename HaloGenerator>
+            struct generator_static_halos<HaloGenerator,
+                std::enable_if_t<is_static_halos<typename HaloGenerator::static_halos_type>::value>>
+            { using type = typename HaloGenerator::static_halos_type; };
+        } // namespace detail
+
+        /** @brief patterns made by a halo generator with static halo widths (see halo_generator). Fields which
+         * declare their static halo widths (static_halos_type) must carry the widths of the halo generator when
+         * bound to these patterns, such that their halos are packed by the kernels specialized for these widths.
+         * @tparam PatternContainer pattern container type
+         * @tparam StaticHalos static_halos<...> of the halo generator */
+        template<typename PatternContainer, typename StaticHalos>
+        class static_halo_pattern_container : public PatternContainer
+        {
+        public: // member types
+            using static_halos_type = StaticHalos;
+
+        public: // ctors
+            explicit static_halo_pattern_container(PatternContainer&& pc) : PatternContainer(std::move(pc)) {}
+
+        public: // member functions
+            /** @brief bind a field to a pattern
+             * @tparam Field field type
+             * @param field field instance
+             * @return lightweight buffer_info object. Attention: holds references to field and pattern! */
+            template<typename Field>
+            auto operator()(Field& field) const
+            {
+                static_assert(detail::has_static_halos<Field, StaticHalos>::value,
+                    "field must be wrapped with the static_halos of the halo generator");
+                return PatternContainer::operator()(field);
+            }
+        };
+
+        namespace detail {
+            // patterns of a halo generator with static halo widths carry these widths
+            template<typename StaticHalos>
+            struct with_static_halos
+            {
+                template<typename PatternContainer>
+                static auto apply(PatternContainer&& pc)
+                {
+                    return static_halo_pattern_container<PatternContainer,StaticHalos>(std::move(pc));
+                }
+            };
+            template<>
+            struct with_static_halos<void>
+            {
+                template<typename PatternContainer>
+                static PatternContainer apply(PatternContainer&& pc) { return std::move(pc); }
+            };
+        } // namespace detail
+    } // namespace structured
+
     namespace detail {
 
+        // append n trivially copyable values to a byte buffer
+        template<typename T>
+        inline void write_bytes(std::vector<char>& buffer, const T* values, std::size_t n)
+        {
+            const auto s = buffer.size();
+            buffer.resize(s + sizeof(T)*n);
+            if (n) std::memcpy(buffer.data()+s, values, sizeof(T)*n);
+        }
+        template<typename T>
+        inline void write_bytes(std::vector<char>& buffer, const T& value) { write_bytes(buffer, &value, 1); }
+
+        // read n trivially copyable values from a byte buffer and advance the read pointer
+        template<typename T>
+        inline void read_bytes(const char*& ptr, T* values, std::size_t n)
+        {
+            if (n) std::memcpy(values, ptr, sizeof(T)*n);
+            ptr += sizeof(T)*n;
+        }
+        template<typename T>
+        inline void read_bytes(const char*& ptr, T& value) { read_bytes(ptr, &value, 1); }
+
+        // append a halo map to a byte buffer: number of entries, then the extended domain id, the number of
+        // iteration spaces and the iteration spaces of each entry
+        template<typename Map>
+        inline void write_halos(std::vector<char>& buffer, const Map& m)
+        {
+            write_bytes(buffer, static_cast<int>(m.size()));
+            for (const auto& x : m)
+            {
+                write_bytes(buffer, x.first);
+                write_bytes(buffer, static_cast<int>(x.second.size()));
+                write_bytes(buffer, x.second.data(), x.second.size());
+            }
+        }
+
+        // append a map of domain extents to a byte buffer: number of entries, then domain id and extents
+        template<typename Map>
+        inline void write_domains(std::vector<char>& buffer, const Map& m)
+        {
+            write_bytes(buffer, static_cast<int>(m.size()));
+            for (const auto& x : m)
+            {
+                write_bytes(buffer, x.first);
+                write_bytes(buffer, x.second);
+            }
+        }
+
+        // read a map of domain extents from a byte buffer and advance the read pointer
+        template<typename Map>
+        inline void read_domains(const char*& ptr, Map& m)
+        {
+            int num_entries;
+            read_bytes(ptr, num_entries);
+            for (int i=0; i<num_entries; ++i)
+            {
+                typename Map::key_type id;
+                read_bytes(ptr, id);
+                read_bytes(ptr, m[id]);
+            }
+        }
+
+        // read a halo map from a byte buffer and advance the read pointer
+        template<typename Map>
+        inline void read_halos(const char*& ptr, Map& m)
+        {
+            int num_entries;
+            read_bytes(ptr, num_entries);
+            for (int i=0; i<num_entries; ++i)
+            {
+                typename Map::key_type id;
+                read_bytes(ptr, id);
+                int num_is;
+                read_bytes(ptr, num_is);
+                auto& vec = m.emplace_hint(m.end(), id, typename Map::mapped_type(num_is))->second;
+                read_bytes(ptr, vec.data(), num_is);
+            }
+        }
+
+        // true if the pattern can be computed analytically (regular halo generator and Cartesian decomposition)
+        template<typename HaloGenerator, typename DomainRange>
+        struct is_cartesian_setup : public std::false_type {};
+
+        template<int Dimension, typename StaticHalos>
+        struct is_cartesian_setup<
+            structured::regular::halo_generator<int,Dimension,StaticHalos>,
+            structured::regular::cartesian_decomposition<Dimension>> : public std::true_type {};
+
         // constructs the pattern with the help of all to all communications
         template<typename CoordinateArrayType>
         struct make_pattern_impl<::gridtools::ghex::structured::detail::grid<CoordinateArrayType>>
         {
-            template<typename Transport, typename HaloGenerator, typename DomainRange>
+            template<typename Transport, typename HaloGenerator, typename DomainRange,
+                typename std::enable_if<!is_cartesian_setup<std::decay_t<HaloGenerator>,
+                    std::decay_t<DomainRange>>::value, int>::type = 0>
             static auto apply(tl::context<Transport>& context, HaloGenerator&& hgen, DomainRange&& d_range)
             {
                 // typedefs
@@ -268,7 +437,6 @@ namespace gridtools {
                 auto num_domain_ids  = comm.all_gather(my_num_domains).get();
                 auto domain_ids      = comm.all_gather(my_domain_ids, num_domain_ids).get();
                 auto domain_extents  = comm.all_gather(my_domain_extents, num_domain_ids).get();
-                const int world_size = num_domain_ids.size();
 
                 // find global extents
                 auto global_min = my_domain_extents[0].global().first();
@@ -285,6 +453,19 @@ namespace gridtools {
                     pat.global_last()  = global_max;
                 }
 
+                // spatial index over all domains: domain n is domain k of rank flat_ids[n]
+                std::vector<std::pair<int,int>> flat_ids;
+                std::vector<iteration_space> flat_extents;
+                for (unsigned int j=0; j<domain_extents.size(); ++j)
+                    for (unsigned int k=0; k<domain_extents[j].size(); ++k)
+                    {
+                        flat_ids.push_back(std::make_pair(j,k));
+                        flat_extents.push_back(domain_extents[j][k].global());
+                    }
+                const ::gridtools::ghex::structured::box_index<coordinate_type> index(
+                    global_min, global_max, flat_extents);
+                std::vector<std::size_t> candidates;
+
                 // check my receive halos against all existing domains (i.e. intersection check)
                 // in order to decide from which domain I shall be receiving from.
                 // loop over patterns/domains
@@ -293,35 +474,32 @@ namespace gridtools {
                 {
                     // get corresponding halos
                     const auto& recv_halos = my_generated_recv_halos[i];
-                    // intersect each halo with all domain extents
+                    // intersect each halo with the domain extents which overlap it (the global part of an
+                    // intersection is always contained in both global boxes)
                     for (const auto& halo : recv_halos)
                     {
-                        // loop over all ranks
-                        for (unsigned int j=0; j<domain_extents.size(); ++j)
+                        candidates.clear();
+                        index.query(coordinate_type{halo.global().first()}, coordinate_type{halo.global().last()},
+                            candidates);
+                        // loop over candidates in the order of ranks and domains
+                        for (const auto n : candidates)
                         {
-                            // get vectors of extents and ids per rank
-                            const auto& extents_vec   = domain_extents[j];
-                            const auto& domain_id_vec = domain_ids[j];
-                            // loop over extents and ids
-                            for (unsigned int k=0; k<extents_vec.size(); ++k)
-                            {
-                                // intersect in global coordinates
-                                const auto& extent = extents_vec[k];
-                                const auto& domain_id = domain_id_vec[k];
-                                const auto x =
-                                hgen.intersect(*d_it, halo.local().first(),    halo.local().last(),
-                                                      halo.global().first(),   halo.global().last(),
-                                                      extent.global().first(), extent.global().last());
-                                const coordinate_type x_global_first{x.global().first()};
-                                const coordinate_type x_global_last{x.global().last()};
-                                if (x_global_first <= x_global_last) {
-                                    my_patterns[i].recv_halos()[domain_id].push_back(
-                                        iteration_space_pair{
-                                            iteration_space{
-                                                coordinate_type{x.local().first()},
-                                                coordinate_type{x.local().last()}},
-                                            iteration_space{x_global_first, x_global_last}});
-                                }
+                            // intersect in global coordinates
+                            const auto& extent = domain_extents[flat_ids[n].first][flat_ids[n].second];
+                            const auto& domain_id = domain_ids[flat_ids[n].first][flat_ids[n].second];
+                            const auto x =
+                            hgen.intersect(*d_it, halo.local().first(),    halo.local().last(),
+                                                  halo.global().first(),   halo.global().last(),
+                                                  extent.global().first(), extent.global().last());
+                            const coordinate_type x_global_first{x.global().first()};
+                            const coordinate_type x_global_last{x.global().last()};
+                            if (x_global_first <= x_global_last) {
+                                my_patterns[i].recv_halos()[domain_id].push_back(
+                                    iteration_space_pair{
+                                        iteration_space{
+                                            coordinate_type{x.local().first()},
+                                            coordinate_type{x.local().last()}},
+                                        iteration_space{x_global_first, x_global_last}});
                             }
                         }
                     }
@@ -436,144 +614,301 @@ namespace gridtools {
                     send_halos_map.erase(it);
                 }
 
-                // loop over all ranks and establish connection
-                for (int rank = 0; rank<world_size; ++rank)
+                // send the halos to the corresponding PEs with a sparse data exchange, such that only the neighbors
+                // communicate. The message to a rank consists of
+                // - the number of domains, and for each domain
+                //   - the domain id and the number of extended domain ids, and for each extended domain id
+                //     - the extended domain id, the number of iteration spaces and the iteration spaces
+                std::map<int, std::vector<char>> messages;
+                for (const auto& p : send_halos_map)
                 {
-                    if (rank == comm.rank())
+                    auto& msg = messages[p.first];
+                    write_bytes(msg, static_cast<int>(p.second.size()));
+                    for (const auto& p1 : p.second)
                     {
-                        // broadcast number of connecting ranks
-                        int num_ranks = send_halos_map.size();
-                        comm.broadcast(num_ranks, rank);
-
-                        if (num_ranks > 0)
+                        write_bytes(msg, p1.first);
+                        write_bytes(msg, static_cast<int>(p1.second.size()));
+                        for (const auto& p2 : p1.second)
                         {
-                            // broadcast ranks
-                            std::vector<int> ranks;
-                            ranks.reserve(num_ranks);
-                            for (const auto& p : send_halos_map)
-                                ranks.push_back(p.first);
-                            comm.broadcast(&ranks[0],num_ranks,rank);
-
-                            // send number of domains to each rank
-                            std::vector<int> num_domains;
-                            num_domains.reserve(num_ranks);
-                            for (const auto& p : send_halos_map)
-                                num_domains.push_back(p.second.size());
-                            int j=0;
-                            for (auto& nd : num_domains)
-                                comm.send(ranks[j++], 0, nd);
-
-                            j=0;
-                            for (const auto& p : send_halos_map)
-                            {
-                                // send domain ids
-                                std::vector<domain_id_type> dom_ids;
-                                dom_ids.reserve(num_domains[j]);
-                                for (const auto& p1 : p.second)
-                                    dom_ids.push_back(p1.first);
-                                comm.send(ranks[j], 0, &dom_ids[0], num_domains[j]);
-
-                                // send number of id_iteration_space pairs per domain
-                                std::vector<int> num_pairs;
-                                num_pairs.reserve(num_domains[j]);
-                                for (const auto& p1 : p.second)
-                                    num_pairs.push_back(p1.second.size());
-                                comm.send(ranks[j], 0, &num_pairs[0], num_domains[j]);
-
-                                int k=0;
-                                for (const auto& p1 : p.second)
-                                {
-                                    // send extended_domain_ids for each domain j and each pair k
-                                    std::vector<extended_domain_id_type> my_dom_ids;
-                                    my_dom_ids.reserve(num_pairs[k]);
-                                    for (const auto& p2 : p1.second)
-                                        my_dom_ids.push_back(p2.first);
-                                    comm.send(ranks[j], 0, &my_dom_ids[0], num_pairs[k]);
-
-                                    // send all iteration spaces for each domain j, each pair k
-                                    for (const auto& p2 :  p1.second)
-                                    {
-                                        int num_is = p2.second.size();
-                                        comm.send(ranks[j], 0, num_is);
-                                        comm.send(ranks[j], 0, &p2.second[0], num_is);
-                                    }
-                                    ++k;
-                                }
-                                ++j;
-                            }
+                            write_bytes(msg, p2.first);
+                            write_bytes(msg, static_cast<int>(p2.second.size()));
+                            write_bytes(msg, p2.second.data(), p2.second.size());
                         }
                     }
-                    else
+                }
+                // messages are processed in the order of the source ranks
+                for (const auto& r : comm.sparse_exchange(messages, 0))
+                {
+                    const char* ptr = r.second.data();
+                    int num_domains;
+                    read_bytes(ptr, num_domains);
+                    for (int j=0; j<num_domains; ++j)
                     {
-                        // broadcast number of connecting ranks
-                        int num_ranks;
-                        comm.broadcast(num_ranks, rank);
-
-                        if (num_ranks > 0)
+                        domain_id_type dom_id;
+                        read_bytes(ptr, dom_id);
+                        int num_pairs;
+                        read_bytes(ptr, num_pairs);
+                        // find domain in my list of patterns
+                        int k=0;
+                        for (const auto& pat : my_patterns)
+                        {
+                            if (pat.domain_id() == dom_id) break;
+                            ++k;
+                        }
+                        auto& pat = my_patterns[k];
+                        // recv all iteration spaces for each pair
+                        for (int l=0; l<num_pairs; ++l)
                         {
-                            // broadcast ranks
-                            std::vector<int> ranks(num_ranks);
-                            comm.broadcast(&ranks[0],num_ranks,rank);
+                            extended_domain_id_type did;
+                            read_bytes(ptr, did);
+                            int num_is;
+                            read_bytes(ptr, num_is);
+                            std::vector<iteration_space_pair> is(num_is);
+                            read_bytes(ptr, is.data(), num_is);
+                            auto& vec = pat.send_halos()[did];
+                            vec.insert(vec.end(), is.begin(), is.end());
+                        }
+                    }
+                }
+
+                // store the extents of the neighbor domains
+                std::map<domain_id_type, iteration_space> all_domains;
+                for (unsigned int j=0; j<domain_ids.size(); ++j)
+                    for (unsigned int k=0; k<domain_ids[j].size(); ++k)
+                        all_domains[domain_ids[j][k].id] = domain_extents[j][k].global();
+                for (auto& p : my_patterns)
+                {
+                    for (const auto& id_is_pair : p.recv_halos())
+                        p.neighbor_domains()[id_is_pair.first.id] = all_domains[id_is_pair.first.id];
+                    for (const auto& id_is_pair : p.send_halos())
+                        p.neighbor_domains()[id_is_pair.first.id] = all_domains[id_is_pair.first.id];
+                }
+
+                using static_halos_type = typename structured::detail::generator_static_halos<
+                    std::decay_t<HaloGenerator>>::type;
+                return structured::detail::with_static_halos<static_halos_type>::apply(
+                    pattern_container<communicator_type,grid_type,domain_id_type>(std::move(my_patterns), m_max_tag));
+            }
 
-                            // check if I am part of the ranks
-                            bool sending = false;
-                            for (auto r : ranks)
+            // constructs the pattern of a Cartesian decomposition without gathering the domains: the extents,
+            // ranks and halos of the neighbor domains are computed locally, and only the addresses are exchanged
+            // with the neighbor ranks
+            template<typename Transport, typename HaloGenerator, typename DomainRange,
+                typename std::enable_if<is_cartesian_setup<std::decay_t<HaloGenerator>,
+                    std::decay_t<DomainRange>>::value, int>::type = 0>
+            static auto apply(tl::context<Transport>& context, HaloGenerator&& hgen, DomainRange&& decomposition)
+            {
+                // typedefs
+                using context_type              = tl::context<Transport>;
+                using decomposition_type        = std::decay_t<DomainRange>;
+                using domain_type               = typename decomposition_type::domain_type;
+                using domain_id_type            = typename domain_type::domain_id_type;
+                using position_type             = typename decomposition_type::position_type;
+                using grid_type                 = ::gridtools::ghex::structured::detail::grid<CoordinateArrayType>;
+                using communicator_type         = typename context_type::communicator_type;
+                using pattern_type              = pattern<communicator_type, grid_type, domain_id_type>;
+                using address_type              = typename pattern_type::address_type;
+                using iteration_space           = typename pattern_type::iteration_space;
+                using iteration_space_pair      = typename pattern_type::iteration_space_pair;
+                using coordinate_type           = typename pattern_type::coordinate_type;
+                using extended_domain_id_type   = typename pattern_type::extended_domain_id_type;
+                // receive halos of a domain: sending domain id -> (sending domain position, iteration spaces)
+                using recv_halos_type           = std::map<domain_id_type,
+                                                      std::pair<position_type, std::vector<iteration_space_pair>>>;
+                // tags of a rank: (receiving domain id, sending domain id) -> tag
+                using tags_type                 = std::map<std::pair<domain_id_type,domain_id_type>, int>;
+                // halos of a pair of domains before the addresses are known
+                struct halo_info
+                {
+                    int                               rank;
+                    domain_id_type                    id;
+                    int                               tag;
+                    std::vector<iteration_space_pair> spaces;
+                };
+
+                auto comm = tl::mpi::setup_communicator(context.mpi_comm());
+                auto new_comm = context.get_serial_communicator();
+                const address_type my_address = new_comm.address();
+                const int my_rank = comm.rank();
+                const coordinate_type global_min{decomposition.global_first()};
+                const coordinate_type global_max{decomposition.global_last()};
+
+                // receive halos of any domain (the same computation as in the general case, but only the
+                // domains overlapping a halo are visited)
+                std::map<domain_id_type, recv_halos_type> recv_halos_cache;
+                auto recv_halos = [&hgen,&decomposition,&recv_halos_cache](const position_type& pos)
+                    -> const recv_halos_type&
+                {
+                    const auto d = decomposition.domain(pos);
+                    auto it = recv_halos_cache.find(d.domain_id());
+                    if (it != recv_halos_cache.end()) return it->second;
+                    auto& res = recv_halos_cache[d.domain_id()];
+                    for (const auto& h : hgen(d))
+                    {
+                        const iteration_space_pair is{
+                            iteration_space{coordinate_type{h.local().first()},coordinate_type{h.local().last()}},
+                            iteration_space{coordinate_type{h.global().first()},coordinate_type{h.global().last()}}};
+                        if (!(is.local().first() <= is.local().last())) continue;
+                        decomposition.for_each_overlapping(is.global().first(), is.global().last(),
+                            [&](const position_type& pos_b)
                             {
-                                if (r == comm.rank())
-                                {
-                                    sending = true;
-                                    break;
+                                const auto b = decomposition.domain(pos_b);
+                                const auto x =
+                                hgen.intersect(d, is.local().first(),  is.local().last(),
+                                                  is.global().first(), is.global().last(),
+                                                  coordinate_type{b.first()}, coordinate_type{b.last()});
+                                const coordinate_type x_global_first{x.global().first()};
+                                const coordinate_type x_global_last{x.global().last()};
+                                if (x_global_first <= x_global_last) {
+                                    auto& entry = res[b.domain_id()];
+                                    entry.first = pos_b;
+                                    entry.second.push_back(
+                                        iteration_space_pair{
+                                            iteration_space{
+                                                coordinate_type{x.local().first()},
+                                                coordinate_type{x.local().last()}},
+                                            iteration_space{x_global_first, x_global_last}});
                                 }
-                            }
-                            if (sending)
-                            {
-                                // recv number of domains
-                                int num_domains;
-                                comm.recv(rank, 0, num_domains);
+                            });
+                    }
+                    return res;
+                };
 
-                                // recv domain ids
-                                std::vector<domain_id_type> dom_ids(num_domains);
-                                comm.recv(rank, 0, &dom_ids[0], num_domains);
+                // tags assigned by a rank to its receive halos (same algorithm as in the general case)
+                std::map<int, tags_type> tags_cache;
+                int m_max_tag = 0;
+                auto tags = [&decomposition,&recv_halos,&tags_cache,&m_max_tag,my_rank](int rank)
+                    -> const tags_type&
+                {
+                    auto it = tags_cache.find(rank);
+                    if (it != tags_cache.end()) return it->second;
+                    auto& res = tags_cache[rank];
+                    std::map<int,int> tag_map;
+                    for (const auto& pos : decomposition.positions(rank))
+                    {
+                        const auto id = decomposition.domain_id(pos);
+                        for (const auto& h : recv_halos(pos))
+                        {
+                            const int source = decomposition.rank(h.second.first);
+                            auto t_it = tag_map.find(source);
+                            int tag = 0;
+                            if (t_it == tag_map.end())
+                                tag_map[source] = 0;
+                            else
+                                tag = ++t_it->second;
+                            if (rank == my_rank) m_max_tag = std::max(tag, m_max_tag);
+                            res[std::make_pair(id, h.first)] = tag;
+                        }
+                    }
+                    return res;
+                };
 
-                                // recv number of id_iteration_space pairs per domain
-                                std::vector<int> num_pairs(num_domains);
-                                comm.recv(rank, 0, &num_pairs[0], num_domains);
+                // extents of the domain at a grid position
+                auto domain_extents = [&decomposition](const position_type& pos)
+                {
+                    const auto b = decomposition.domain(pos);
+                    return iteration_space{coordinate_type{b.first()}, coordinate_type{b.last()}};
+                };
 
-                                int j=0;
-                                for (auto np : num_pairs)
-                                {
-                                    // recv extended_domain_ids for each domain j and all its np pairs
-                                    std::vector<extended_domain_id_type> send_dom_ids(np);
-                                    comm.recv(rank, 0, &send_dom_ids[0], np);
-
-                                    // find domain in my list of patterns
-                                    int k=0;
-                                    for (const auto& pat : my_patterns)
-                                    {
-                                        if (pat.domain_id() == dom_ids[j]) break;
-                                        ++k;
-                                    }
-                                    auto& pat = my_patterns[k];
-
-                                    // recv all iteration spaces for each domain and each pair
-                                    for (const auto& did : send_dom_ids)
-                                    {
-                                        int num_is;
-                                        comm.recv(rank, 0, num_is);
-                                        std::vector<iteration_space_pair> is(num_is);
-                                        comm.recv(rank, 0, &is[0], num_is);
-                                        auto& vec = pat.send_halos()[did];
-                                        vec.insert(vec.end(), is.begin(), is.end());
-                                    }
-                                    ++j;
-                                }
+                const auto& halos = hgen.halos();
+                const auto& periodic = hgen.periodic();
+                const coordinate_type global_extents = global_max - global_min + 1;
+                std::vector<pattern_type>           my_patterns;
+                std::vector<std::vector<halo_info>> my_recv_halos;
+                std::vector<std::vector<halo_info>> my_send_halos;
+                std::vector<int>                    neighbors;
+                for (const auto& pos : decomposition.positions(my_rank))
+                {
+                    const auto d = decomposition.domain(pos);
+                    const coordinate_type d_first{d.first()};
+                    const coordinate_type d_last{d.last()};
+                    my_patterns.emplace_back(
+                        iteration_space_pair{
+                            iteration_space{d_first-d_first, d_last-d_first},
+                            iteration_space{d_first, d_last}},
+                        extended_domain_id_type{d.domain_id(), my_rank, my_address, 0});
+                    my_patterns.back().global_first() = global_min;
+                    my_patterns.back().global_last()  = global_max;
 
-                            }
+                    // receive halos
+                    my_recv_halos.resize(my_recv_halos.size()+1);
+                    const auto& my_tags = tags(my_rank);
+                    for (const auto& h : recv_halos(pos))
+                    {
+                        const int rank = decomposition.rank(h.second.first);
+                        my_recv_halos.back().push_back(halo_info{rank, h.first,
+                            my_tags.find(std::make_pair(d.domain_id(), h.first))->second, h.second.second});
+                        my_patterns.back().neighbor_domains()[h.first] = domain_extents(h.second.first);
+                        neighbors.push_back(rank);
+                    }
+
+                    // send halos: the domains receiving from d overlap d extended by the opposite halo widths
+                    // (or one of its periodic images)
+                    std::vector<position_type> candidates;
+                    for (int n=0; n<::gridtools::ghex::detail::ct_pow(3,coordinate_type::size()); ++n)
+                    {
+                        coordinate_type first, last;
+                        bool valid = true;
+                        for (int k=0, m=n; k<coordinate_type::size(); ++k, m/=3)
+                        {
+                            const int shift = m%3-1;
+                            if (shift != 0 && !periodic[k]) valid = false;
+                            first[k] = d_first[k] - halos[k*2+1] + shift*global_extents[k];
+                            last[k]  = d_last[k]  + halos[k*2]   + shift*global_extents[k];
                         }
+                        if (valid)
+                            decomposition.for_each_overlapping(first, last,
+                                [&candidates](const position_type& p) { candidates.push_back(p); });
                     }
+                    std::sort(candidates.begin(), candidates.end());
+                    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+                    my_send_halos.resize(my_send_halos.size()+1);
+                    for (const auto& pos_b : candidates)
+                    {
+                        const auto& b_halos = recv_halos(pos_b);
+                        auto it = b_halos.find(d.domain_id());
+                        if (it == b_halos.end()) continue;
+                        const auto b_id = decomposition.domain_id(pos_b);
+                        const int rank = decomposition.rank(pos_b);
+                        // recast the iteration spaces to my local coordinates
+                        std::vector<iteration_space_pair> spaces(it->second.second);
+                        for (auto& is : spaces)
+                        {
+                            is.local().first() = is.global().first() - d_first;
+                            is.local().last()  = is.global().last()  - d_first;
+                        }
+                        my_send_halos.back().push_back(halo_info{rank, b_id,
+                            tags(rank).find(std::make_pair(b_id, d.domain_id()))->second, std::move(spaces)});
+                        my_patterns.back().neighbor_domains()[b_id] = domain_extents(pos_b);
+                        neighbors.push_back(rank);
+                    }
+                }
+
+                // exchange the addresses with the neighbor ranks (one message per rank)
+                neighbors.erase(std::remove(neighbors.begin(), neighbors.end(), my_rank), neighbors.end());
+                const auto neighbor_addresses = comm.neighbor_exchange(my_address, neighbors, 0);
+                std::map<int, address_type> addresses;
+                addresses[my_rank] = my_address;
+                for (unsigned int i=0; i<neighbors.size(); ++i)
+                    addresses[neighbors[i]] = neighbor_addresses[i];
+
+                for (unsigned int i=0; i<my_patterns.size(); ++i)
+                {
+                    for (auto& h : my_recv_halos[i])
+                        my_patterns[i].recv_halos()[extended_domain_id_type{h.id, h.rank, addresses[h.rank], h.tag}] =
+                            std::move(h.spaces);
+                    for (auto& h : my_send_halos[i])
+                        my_patterns[i].send_halos()[extended_domain_id_type{h.id, h.rank, addresses[h.rank], h.tag}] =
+                            std::move(h.spaces);
                 }
 
-                return pattern_container<communicator_type,grid_type,domain_id_type>(std::move(my_patterns), m_max_tag);
+                // maximum tag among all ranks
+                m_max_tag = comm.all_max(m_max_tag);
+
+                using static_halos_type = typename structured::detail::generator_static_halos<
+                    std::decay_t<HaloGenerator>>::type;
+                return structured::detail::with_static_halos<static_halos_type>::apply(
+                    pattern_container<communicator_type,grid_type,domain_id_type>(std::move(my_patterns), m_max_tag));
             }
 
             template<typename Transport, typename HaloGenerator, typename RecvDomainIdsGen, typename DomainRange>
@@ -583,6 +918,287 @@ namespace gridtools {
             }
         };
 
+        // updates the patterns after domains have migrated between ranks: the halos of the migrated domains do not
+        // change, only the owners, addresses and tags of the affected domain pairs
+        template<typename CoordinateArrayType>
+        struct update_pattern_impl<::gridtools::ghex::structured::detail::grid<CoordinateArrayType>>
+        {
+            template<typename Transport, typename PatternContainer>
+            static void apply(tl::context<Transport>& context, PatternContainer& pc,
+                const std::vector<typename PatternContainer::migration_type>& migrations)
+            {
+                // typedefs
+                using pattern_type              = typename PatternContainer::value_type;
+                using domain_id_type            = typename pattern_type::domain_id_type;
+                using address_type              = typename pattern_type::address_type;
+                using iteration_space           = typename pattern_type::iteration_space;
+                using iteration_space_pair      = typename pattern_type::iteration_space_pair;
+                using extended_domain_id_type   = typename pattern_type::extended_domain_id_type;
+
+                auto comm = tl::mpi::setup_communicator(context.mpi_comm());
+                auto new_comm = context.get_serial_communicator();
+                const address_type my_address = new_comm.address();
+                const int my_rank = comm.rank();
+                const std::map<domain_id_type,int> new_owners(migrations.begin(), migrations.end());
+                // true if a domain owned by rank has migrated to another rank
+                auto moved = [&new_owners](domain_id_type id, int rank)
+                {
+                    auto it = new_owners.find(id);
+                    return it != new_owners.end() && it->second != rank;
+                };
+
+                // move the patterns of the migrated domains to their new owners. The message to a rank consists of
+                // a list of patterns: domain id, domain and global extents, the receive and send halos, and the
+                // extents of the neighbor domains
+                std::vector<pattern_type> my_patterns;
+                std::map<int, std::vector<char>> messages;
+                for (auto& p : pc)
+                {
+                    if (!moved(p.domain_id(), my_rank))
+                    {
+                        my_patterns.push_back(std::move(p));
+                        continue;
+                    }
+                    auto& msg = messages[new_owners.find(p.domain_id())->second];
+                    write_bytes(msg, p.domain_id());
+                    write_bytes(msg, p.global_domain());
+                    write_bytes(msg, p.global_first());
+                    write_bytes(msg, p.global_last());
+                    write_halos(msg, p.recv_halos());
+                    write_halos(msg, p.send_halos());
+                    write_domains(msg, p.neighbor_domains());
+                }
+                const std::size_t num_kept = my_patterns.size();
+                for (const auto& r : comm.sparse_exchange(messages, 0))
+                {
+                    const char* ptr = r.second.data();
+                    const char* end = ptr + r.second.size();
+                    while (ptr != end)
+                    {
+                        domain_id_type id;
+                        read_bytes(ptr, id);
+                        iteration_space global;
+                        read_bytes(ptr, global);
+                        my_patterns.emplace_back(
+                            iteration_space_pair{
+                                iteration_space{global.first()-global.first(), global.last()-global.first()},
+                                global},
+                            extended_domain_id_type{id, my_rank, my_address, 0});
+                        read_bytes(ptr, my_patterns.back().global_first());
+                        read_bytes(ptr, my_patterns.back().global_last());
+                        read_halos(ptr, my_patterns.back().recv_halos());
+                        read_halos(ptr, my_patterns.back().send_halos());
+                        read_domains(ptr, my_patterns.back().neighbor_domains());
+                    }
+                }
+
+                // set the new owners of the neighbor domains. The receive halos of the domain pairs where neither
+                // domain has migrated keep their tags, the others are assigned the smallest tags which are not in
+                // use for the pair of ranks.
+                std::map<int, std::set<int>> used_tags;
+                std::vector<std::pair<std::size_t, extended_domain_id_type*>> affected;
+                for (std::size_t i=0; i<my_patterns.size(); ++i)
+                {
+                    for (auto& id_is_pair : my_patterns[i].recv_halos())
+                    {
+                        auto& id = const_cast<extended_domain_id_type&>(id_is_pair.first);
+                        const bool remote_moved = moved(id.id, id.mpi_rank);
+                        if (remote_moved) id.mpi_rank = new_owners.find(id.id)->second;
+                        if (remote_moved || i >= num_kept)
+                            affected.push_back(std::make_pair(i, &id));
+                        else
+                            used_tags[id.mpi_rank].insert(id.tag);
+                    }
+                    for (auto& id_is_pair : my_patterns[i].send_halos())
+                    {
+                        auto& id = const_cast<extended_domain_id_type&>(id_is_pair.first);
+                        if (moved(id.id, id.mpi_rank)) id.mpi_rank = new_owners.find(id.id)->second;
+                    }
+                }
+
+                // send the new tags and addresses to the other side of the affected domain pairs. The message to a
+                // rank consists of a list of entries: the kind (0: send halo, 1: receive halo), the domain id on
+                // the receiving side, the neighbor domain id, the tag and the address of the sending rank
+                messages.clear();
+                auto write_entry = [&messages,&my_address](int rank, int kind, domain_id_type id,
+                    domain_id_type neighbor_id, int tag)
+                {
+                    auto& msg = messages[rank];
+                    write_bytes(msg, kind);
+                    write_bytes(msg, id);
+                    write_bytes(msg, neighbor_id);
+                    write_bytes(msg, tag);
+                    write_bytes(msg, my_address);
+                };
+                for (auto& a : affected)
+                {
+                    auto& tags = used_tags[a.second->mpi_rank];
+                    int tag = 0;
+                    while (tags.count(tag)) ++tag;
+                    tags.insert(tag);
+                    a.second->tag = tag;
+                    write_entry(a.second->mpi_rank, 0, a.second->id, my_patterns[a.first].domain_id(), tag);
+                }
+                for (std::size_t i=num_kept; i<my_patterns.size(); ++i)
+                    for (const auto& id_is_pair : my_patterns[i].send_halos())
+                        write_entry(id_is_pair.first.mpi_rank, 1, id_is_pair.first.id, my_patterns[i].domain_id(), 0);
+                for (const auto& r : comm.sparse_exchange(messages, 0))
+                {
+                    const char* ptr = r.second.data();
+                    const char* end = ptr + r.second.size();
+                    while (ptr != end)
+                    {
+                        int kind, tag;
+                        domain_id_type id, neighbor_id;
+                        address_type address;
+                        read_bytes(ptr, kind);
+                        read_bytes(ptr, id);
+                        read_bytes(ptr, neighbor_id);
+                        read_bytes(ptr, tag);
+                        read_bytes(ptr, address);
+                        auto p_it = std::find_if(my_patterns.begin(), my_patterns.end(),
+                            [id](const pattern_type& p) { return p.domain_id() == id; });
+                        if (p_it == my_patterns.end())
+                            throw std::runtime_error("update pattern: domain not found");
+                        auto& halos = (kind == 0) ? p_it->send_halos() : p_it->recv_halos();
+                        auto h_it = std::find_if(halos.begin(), halos.end(),
+                            [neighbor_id](const auto& h) { return h.first.id == neighbor_id; });
+                        if (h_it == halos.end())
+                            throw std::runtime_error("update pattern: neighbor domain not found");
+                        // the ordering of the halos is not affected since the domain ids are unique
+                        auto& h_id = const_cast<extended_domain_id_type&>(h_it->first);
+                        h_id.mpi_rank = r.first;
+                        h_id.address = address;
+                        if (kind == 0) h_id.tag = tag;
+                    }
+                }
+
+                // maximum tag among all ranks
+                int max_tag = 0;
+                for (const auto& p : my_patterns)
+                    for (const auto& id_is_pair : p.recv_halos())
+                        max_tag = std::max(max_tag, id_is_pair.first.tag);
+                pc.reset(std::move(my_patterns), comm.all_max(max_tag));
+            }
+        };
+
+        // first coordinate of an iteration space relative to a domain along dimension d, taking the periodic image
+        // which is closest to the domain
+        template<typename IterationSpace, typename Domain>
+        inline int relative_first(const IterationSpace& is, const Domain& domain, int d, int global_extent)
+        {
+            const int extent = domain.last()[d] - domain.first()[d] + 1;
+            const int length = is.last()[d] - is.first()[d];
+            int first = 0;
+            int distance = -1;
+            for (int shift : {0, -global_extent, global_extent})
+            {
+                const int f = is.first()[d] - domain.first()[d] + shift;
+                const int dist = f > extent-1 ? f-extent+1 : (f+length < 0 ? -f-length : 0);
+                if (distance < 0 || dist < distance)
+                {
+                    first = f;
+                    distance = dist;
+                }
+            }
+            return first;
+        }
+
+        // restricts the patterns to narrower halos and to a range of the last dimension. Each iteration space is
+        // clipped relative to the receiving domain, using global coordinates only, such that the sending and the
+        // receiving side obtain the same result. The position of an iteration space relative to the receiving
+        // domain is taken from the periodic image closest to the domain, which is unique as long as the receiving
+        // domain together with its halos does not wrap around a periodic dimension.
+        template<typename CoordinateArrayType>
+        struct restrict_pattern_impl<::gridtools::ghex::structured::detail::grid<CoordinateArrayType>>
+        {
+            template<typename PatternContainer, typename Halos>
+            static void apply(PatternContainer& pc, const Halos& halos)
+            {
+                apply_impl(pc, halos, false, 0, 0);
+            }
+
+            template<typename PatternContainer, typename Halos, typename Range>
+            static void apply(PatternContainer& pc, const Halos& halos, const Range& k_range)
+            {
+                auto it = std::begin(k_range);
+                const int k_first = *it++;
+                const int k_last = *it;
+                apply_impl(pc, halos, true, k_first, k_last);
+            }
+
+            template<typename PatternContainer, typename Halos>
+            static void apply_impl(PatternContainer& pc, const Halos& halos, bool clip_k, int k_first, int k_last)
+            {
+                using pattern_type    = typename PatternContainer::value_type;
+                using coordinate_type = typename pattern_type::coordinate_type;
+                using map_type        = typename pattern_type::map_type;
+                static constexpr int dim = coordinate_type::size();
+                const std::vector<int> h(std::begin(halos), std::end(halos));
+                if (h.size() != 2u*dim)
+                    throw std::runtime_error("restrict pattern: wrong number of halo widths");
+
+                for (auto& p : pc)
+                {
+                    const coordinate_type global_extents = p.global_last() - p.global_first() + 1;
+                    // clip the iteration spaces of one neighbor relative to the receiving domain
+                    auto clip = [&](auto& spaces, const auto& recv_domain)
+                    {
+                        const coordinate_type extents = recv_domain.last() - recv_domain.first() + 1;
+                        std::decay_t<decltype(spaces)> res;
+                        for (auto is : spaces)
+                        {
+                            bool empty = false;
+                            for (int d=0; d<dim; ++d)
+                            {
+                                const int length = is.global().last()[d] - is.global().first()[d];
+                                const int first = relative_first(is.global(), recv_domain, d, global_extents[d]);
+                                int lo = std::max(first, -h[2*d]);
+                                int hi = std::min(first+length, extents[d]-1+h[2*d+1]);
+                                if (clip_k && d == dim-1)
+                                {
+                                    const int offset = is.global().first()[d] - first;
+                                    lo = std::max(lo, k_first-offset);
+                                    hi = std::min(hi, k_last-offset);
+                                }
+                                if (lo > hi)
+                                {
+                                    empty = true;
+                                    break;
+                                }
+                                const int delta_first = lo - first;
+                                const int delta_last = hi - first - length;
+                                is.global().first()[d] += delta_first;
+                                is.global().last()[d]  += delta_last;
+                                is.local().first()[d]  += delta_first;
+                                is.local().last()[d]   += delta_last;
+                            }
+                            if (!empty) res.push_back(is);
+                        }
+                        return res;
+                    };
+
+                    map_type recv_map;
+                    for (const auto& id_is_pair : p.recv_halos())
+                    {
+                        auto spaces = clip(id_is_pair.second, p.global_domain());
+                        if (!spaces.empty()) recv_map[id_is_pair.first] = std::move(spaces);
+                    }
+                    map_type send_map;
+                    for (const auto& id_is_pair : p.send_halos())
+                    {
+                        auto it = p.neighbor_domains().find(id_is_pair.first.id);
+                        if (it == p.neighbor_domains().end())
+                            throw std::runtime_error("restrict pattern: neighbor domain not found");
+                        auto spaces = clip(id_is_pair.second, it->second);
+                        if (!spaces.empty()) send_map[id_is_pair.first] = std::move(spaces);
+                    }
+                    p.recv_halos() = std::move(recv_map);
+                    p.send_halos() = std::move(send_map);
+                }
+            }
+        };
+
     } // namespace detail
     } // namespace ghex
 
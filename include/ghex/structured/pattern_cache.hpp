@@ -0,0 +1,284 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_PATTERN_CACHE_HPP
+#define INCLUDED_GHEX_STRUCTURED_PATTERN_CACHE_HPP
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "./pattern.hpp"
+#include "../transport_layer/mpi/error.hpp"
+
+namespace gridtools {
+    namespace ghex {
+
+    namespace detail {
+
+        // 64 bit FNV-1a hash of a byte range
+        inline std::uint64_t hash_bytes(const void* data, std::size_t n, std::uint64_t h) noexcept
+        {
+            const unsigned char* c = reinterpret_cast<const unsigned char*>(data);
+            for (std::size_t i=0; i<n; ++i)
+            {
+                h ^= c[i];
+                h *= 1099511628211ull;
+            }
+            return h;
+        }
+        template<typename T>
+        inline std::uint64_t hash_value(const T& value, std::uint64_t h) noexcept
+        {
+            return hash_bytes(&value, sizeof(T), h);
+        }
+
+        // read-only memory mapping of a whole file (invalid if the file cannot be mapped)
+        class mapped_file
+        {
+        private: // members
+            const char* m_data = nullptr;
+            std::size_t m_size = 0;
+
+        public: // ctors
+            mapped_file(const std::string& filename)
+            {
+                const int fd = ::open(filename.c_str(), O_RDONLY);
+                if (fd < 0) return;
+                struct stat st;
+                if (::fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    void* ptr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (ptr != MAP_FAILED)
+                    {
+                        m_data = static_cast<const char*>(ptr);
+                        m_size = st.st_size;
+                    }
+                }
+                ::close(fd);
+            }
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+            ~mapped_file()
+            {
+                if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+            }
+
+        public: // member functions
+            const char* data() const noexcept { return m_data; }
+            std::size_t size() const noexcept { return m_size; }
+        };
+
+        // binary file layout of the structured patterns of one rank: a header followed by one record per
+        // pattern, which holds the extended domain id, the domain and global extents, the receive and send
+        // halo maps (number of entries, then extended domain id, number of iteration spaces and the iteration
+        // spaces of each entry), and the extents of the neighbor domains. All values are stored in native
+        // representation, such that the halos can be copied from the mapped file without parsing.
+        template<typename CoordinateArrayType>
+        struct pattern_io<::gridtools::ghex::structured::detail::grid<CoordinateArrayType>>
+        {
+            using grid_type = ::gridtools::ghex::structured::detail::grid<CoordinateArrayType>;
+
+            static constexpr std::uint64_t magic   = 0x5441505845484721ull;
+            static constexpr std::uint32_t version = 2;
+
+            struct header
+            {
+                std::uint64_t magic;
+                std::uint32_t version;
+                std::uint32_t num_patterns;
+                std::uint64_t key;
+                std::uint64_t file_size;
+                int           rank;
+                int           size;
+                int           max_tag;
+                int           padding;
+            };
+
+            template<typename Communicator, typename DomainIdType>
+            static std::vector<char> serialize(const pattern_container<Communicator,grid_type,DomainIdType>& pc,
+                std::uint64_t key, int rank, int size)
+            {
+                std::vector<char> buffer;
+                write_bytes(buffer, header{magic, version, static_cast<std::uint32_t>(pc.size()), key, 0, rank, size,
+                    pc.max_tag(), 0});
+                for (const auto& p : pc)
+                {
+                    write_bytes(buffer, p.extended_domain_id());
+                    write_bytes(buffer, p.global_domain());
+                    write_bytes(buffer, p.global_first());
+                    write_bytes(buffer, p.global_last());
+                    write_halos(buffer, p.recv_halos());
+                    write_halos(buffer, p.send_halos());
+                    write_domains(buffer, p.neighbor_domains());
+                }
+                reinterpret_cast<header*>(buffer.data())->file_size = buffer.size();
+                return buffer;
+            }
+
+            // true if the data holds the patterns of this rank for the key
+            static bool valid(const char* data, std::size_t n, std::uint64_t key, int rank, int size) noexcept
+            {
+                if (!data || n < sizeof(header)) return false;
+                header h;
+                std::memcpy(&h, data, sizeof(header));
+                return h.magic == magic && h.version == version && h.key == key && h.file_size == n &&
+                    h.rank == rank && h.size == size;
+            }
+
+            template<typename Communicator, typename DomainIdType>
+            static pattern_container<Communicator,grid_type,DomainIdType> deserialize(const char* ptr)
+            {
+                using pattern_type            = pattern<Communicator,grid_type,DomainIdType>;
+                using iteration_space         = typename pattern_type::iteration_space;
+                using iteration_space_pair    = typename pattern_type::iteration_space_pair;
+                using extended_domain_id_type = typename pattern_type::extended_domain_id_type;
+                header h;
+                read_bytes(ptr, h);
+                std::vector<pattern_type> patterns;
+                patterns.reserve(h.num_patterns);
+                for (std::uint32_t i=0; i<h.num_patterns; ++i)
+                {
+                    extended_domain_id_type id;
+                    read_bytes(ptr, id);
+                    iteration_space global;
+                    read_bytes(ptr, global);
+                    patterns.emplace_back(
+                        iteration_space_pair{
+                            iteration_space{global.first()-global.first(), global.last()-global.first()},
+                            global},
+                        id);
+                    read_bytes(ptr, patterns.back().global_first());
+                    read_bytes(ptr, patterns.back().global_last());
+                    read_halos(ptr, patterns.back().recv_halos());
+                    read_halos(ptr, patterns.back().send_halos());
+                    read_domains(ptr, patterns.back().neighbor_domains());
+                }
+                return {std::move(patterns), h.max_tag};
+            }
+        };
+
+    } // namespace detail
+
+    namespace structured {
+
+    /** @brief computes a key which identifies the patterns of a decomposition: a hash of the domains and of
+     * their receive halos (as emitted by the halo generator) on all ranks. Must be called by all ranks.
+     * @tparam Transport transport protocol
+     * @tparam HaloGenerator function object which takes a domain as argument
+     * @tparam DomainRange a range type holding domains
+     * @param context transport layer context
+     * @param hgen receive halo generator function object
+     * @param d_range range of local domains
+     * @return key (equal on all ranks) */
+    template<typename Transport, typename HaloGenerator, typename DomainRange>
+    std::uint64_t pattern_key(tl::context<Transport>& context, HaloGenerator&& hgen, DomainRange&& d_range)
+    {
+        using domain_type     = typename std::remove_reference_t<DomainRange>::value_type;
+        using grid_type       = typename grid::template type<domain_type>;
+        using coordinate_type = typename grid_type::coordinate_type;
+        using communicator_type = typename tl::context<Transport>::communicator_type;
+        using address_type    = typename communicator_type::address_type;
+        using ::gridtools::ghex::detail::hash_value;
+        std::uint64_t h = 14695981039346656037ull;
+        h = hash_value(context.rank(), h);
+        h = hash_value(static_cast<std::uint32_t>(sizeof(typename domain_type::domain_id_type)), h);
+        h = hash_value(static_cast<std::uint32_t>(sizeof(coordinate_type)), h);
+        h = hash_value(static_cast<std::uint32_t>(sizeof(address_type)), h);
+        for (const auto& d : d_range)
+        {
+            h = hash_value(d.domain_id(), h);
+            h = hash_value(coordinate_type{d.first()}, h);
+            h = hash_value(coordinate_type{d.last()}, h);
+            for (const auto& halo : hgen(d))
+            {
+                h = hash_value(coordinate_type{halo.local().first()}, h);
+                h = hash_value(coordinate_type{halo.local().last()}, h);
+                h = hash_value(coordinate_type{halo.global().first()}, h);
+                h = hash_value(coordinate_type{halo.global().last()}, h);
+            }
+        }
+        // combine the hashes of all ranks
+        std::uint64_t key;
+        GHEX_CHECK_MPI_RESULT(MPI_Allreduce(&h, &key, 1, MPI_UINT64_T, MPI_BXOR, context.mpi_comm()));
+        return hash_value(context.size(), key);
+    }
+
+    /** @brief writes the patterns of this rank to a binary file (one file per rank)
+     * @tparam Transport transport protocol
+     * @tparam PatternContainer pattern container type
+     * @param context transport layer context
+     * @param pc patterns
+     * @param prefix file name prefix (the rank is appended)
+     * @param key key of the patterns (see pattern_key) */
+    template<typename Transport, typename PatternContainer>
+    void save_pattern(tl::context<Transport>& context, const PatternContainer& pc, const std::string& prefix,
+        std::uint64_t key)
+    {
+        using io_type = ::gridtools::ghex::detail::pattern_io<typename PatternContainer::grid_type>;
+        const auto buffer = io_type::serialize(pc, key, context.rank(), context.size());
+        const std::string filename = prefix + "." + std::to_string(context.rank());
+        const std::string tmp_filename = filename + ".tmp";
+        {
+            std::ofstream f(tmp_filename, std::ios::binary | std::ios::trunc);
+            f.write(buffer.data(), buffer.size());
+            if (!f) throw std::runtime_error("save_pattern: could not write " + tmp_filename);
+        }
+        // replace the file atomically, such that a concurrent reader never sees a partial file
+        if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+            throw std::runtime_error("save_pattern: could not write " + filename);
+    }
+
+    /** @brief constructs the patterns like make_pattern, but loads them from the files written by a previous run
+     * if these were written for the same key (see pattern_key) on all ranks. The files are memory-mapped and
+     * the halos are copied without parsing. Otherwise, the patterns are computed and the files are written.
+     * Must be called by all ranks.
+     * @tparam Transport transport protocol
+     * @tparam HaloGenerator function object which takes a domain as argument
+     * @tparam DomainRange a range type holding domains
+     * @param context transport layer context
+     * @param hgen receive halo generator function object
+     * @param d_range range of local domains
+     * @param prefix file name prefix (the rank is appended)
+     * @return iterable of patterns (one per domain) */
+    template<typename Transport, typename HaloGenerator, typename DomainRange>
+    auto make_cached_pattern(tl::context<Transport>& context, HaloGenerator&& hgen, DomainRange&& d_range,
+        const std::string& prefix)
+    {
+        using domain_type       = typename std::remove_reference_t<DomainRange>::value_type;
+        using domain_id_type    = typename domain_type::domain_id_type;
+        using grid_type         = typename grid::template type<domain_type>;
+        using communicator_type = typename tl::context<Transport>::communicator_type;
+        using io_type           = ::gridtools::ghex::detail::pattern_io<grid_type>;
+        const auto key = pattern_key(context, hgen, d_range);
+        {
+            const ::gridtools::ghex::detail::mapped_file f(prefix + "." + std::to_string(context.rank()));
+            // all ranks must have a valid file
+            int valid = io_type::valid(f.data(), f.size(), key, context.rank(), context.size()) ? 1 : 0;
+            GHEX_CHECK_MPI_RESULT(MPI_Allreduce(MPI_IN_PLACE, &valid, 1, MPI_INT, MPI_MIN, context.mpi_comm()));
+            if (valid)
+                return io_type::template deserialize<communicator_type, domain_id_type>(f.data());
+        }
+        auto pc = make_pattern<grid>(context, std::forward<HaloGenerator>(hgen), std::forward<DomainRange>(d_range));
+        save_pattern(context, pc, prefix, key);
+        return pc;
+    }
+
+    } // namespace structured
+    } // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_PATTERN_CACHE_HPP */
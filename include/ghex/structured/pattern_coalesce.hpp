@@ -0,0 +1,213 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_PATTERN_COALESCE_HPP
+#define INCLUDED_GHEX_STRUCTURED_PATTERN_COALESCE_HPP
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include "./pattern.hpp"
+
+namespace gridtools {
+    namespace ghex {
+    namespace structured {
+
+    namespace detail {
+
+        // true if the union of two iteration space pairs is again an iteration space pair: the boxes must touch
+        // along one dimension and coincide in all others, and the local coordinates must be translated by the
+        // same amount as the global coordinates
+        template<typename IterationSpacePair>
+        inline bool mergeable(const IterationSpacePair& a, const IterationSpacePair& b) noexcept
+        {
+            using dimension = typename IterationSpacePair::dimension;
+            const auto& a_l = a.local();
+            const auto& b_l = b.local();
+            const auto& a_g = a.global();
+            const auto& b_g = b.global();
+            int dim = -1;
+            for (unsigned int d=0; d<dimension::value; ++d)
+            {
+                if (b_l.first()[d]-a_l.first()[d] != b_g.first()[d]-a_g.first()[d]) return false;
+                if (a_l.last()[d]-a_l.first()[d] != a_g.last()[d]-a_g.first()[d]) return false;
+                if (b_l.last()[d]-b_l.first()[d] != b_g.last()[d]-b_g.first()[d]) return false;
+                if (a_g.first()[d] == b_g.first()[d] && a_g.last()[d] == b_g.last()[d]) continue;
+                if (dim != -1) return false;
+                if (a_g.last()[d]+1 != b_g.first()[d] && b_g.last()[d]+1 != a_g.first()[d]) return false;
+                dim = d;
+            }
+            return dim != -1;
+        }
+
+        // grow an iteration space pair to the bounding box of itself and another one
+        template<typename IterationSpacePair>
+        inline void extend(IterationSpacePair& a, const IterationSpacePair& b) noexcept
+        {
+            using dimension = typename IterationSpacePair::dimension;
+            for (unsigned int d=0; d<dimension::value; ++d)
+            {
+                a.local().first()[d]  = std::min(a.local().first()[d],  b.local().first()[d]);
+                a.local().last()[d]   = std::max(a.local().last()[d],   b.local().last()[d]);
+                a.global().first()[d] = std::min(a.global().first()[d], b.global().first()[d]);
+                a.global().last()[d]  = std::max(a.global().last()[d],  b.global().last()[d]);
+            }
+        }
+
+        // merge the iteration spaces of one neighbor until no pair can be merged anymore. The merged iteration
+        // space takes the place of the first one. Returns, for each remaining iteration space, the indices of
+        // the original iteration spaces it is made of.
+        template<typename IterationSpacePair>
+        std::vector<std::vector<int>> coalesce(std::vector<IterationSpacePair>& spaces)
+        {
+            std::vector<std::vector<int>> members(spaces.size());
+            for (unsigned int i=0; i<spaces.size(); ++i) members[i].push_back(i);
+            bool merged = true;
+            while (merged)
+            {
+                merged = false;
+                for (unsigned int i=0; i<spaces.size(); ++i)
+                {
+                    for (unsigned int j=i+1; j<spaces.size();)
+                    {
+                        if (mergeable(spaces[i], spaces[j]))
+                        {
+                            extend(spaces[i], spaces[j]);
+                            members[i].insert(members[i].end(), members[j].begin(), members[j].end());
+                            spaces.erase(spaces.begin()+j);
+                            members.erase(members.begin()+j);
+                            merged = true;
+                        }
+                        else
+                            ++j;
+                    }
+                }
+            }
+            return members;
+        }
+
+        // merge the iteration spaces of one neighbor as computed by the other side of the communication
+        template<typename IterationSpacePair>
+        void coalesce(std::vector<IterationSpacePair>& spaces, const std::vector<std::vector<int>>& members)
+        {
+            std::vector<IterationSpacePair> res;
+            res.reserve(members.size());
+            unsigned int count = 0;
+            for (const auto& m : members)
+            {
+                if (m.empty()) throw std::runtime_error("coalesce_pattern: send and receive halos are inconsistent");
+                IterationSpacePair is = spaces.at(m[0]);
+                int s = is.size();
+                for (unsigned int k=1; k<m.size(); ++k)
+                {
+                    extend(is, spaces.at(m[k]));
+                    s += spaces[m[k]].size();
+                }
+                // the members are disjoint, so they fill the bounding box exactly if the sizes match
+                if (s != is.local().size() || s != is.global().size())
+                    throw std::runtime_error("coalesce_pattern: send and receive halos are inconsistent");
+                count += m.size();
+                res.push_back(is);
+            }
+            if (count != spaces.size())
+                throw std::runtime_error("coalesce_pattern: send and receive halos are inconsistent");
+            spaces = std::move(res);
+        }
+
+    } // namespace detail
+
+    /** @brief merges the iteration spaces of each neighbor which together form a larger box, such that fewer
+     * (and larger) boxes need to be packed and unpacked. The receiving side decides which iteration spaces are
+     * merged and sends this decision to the sending side, which keeps the order of the elements in the
+     * messages consistent on both sides. Must be called by all ranks, before the patterns are bound to
+     * communication objects.
+     * @tparam Transport transport protocol
+     * @tparam PatternContainer pattern container type (structured grid)
+     * @param context transport layer context
+     * @param pc patterns
+     * @return number of iteration spaces removed from the send and receive halos of this rank */
+    template<typename Transport, typename PatternContainer>
+    std::size_t coalesce_pattern(tl::context<Transport>& context, PatternContainer& pc)
+    {
+        using domain_id_type = typename PatternContainer::domain_id_type;
+        using ::gridtools::ghex::detail::write_bytes;
+        using ::gridtools::ghex::detail::read_bytes;
+        std::size_t removed = 0;
+
+        // merge the receive halos and send the merged indices to the sending ranks. A message consists of a
+        // list of entries, one for each merged pair of domains:
+        // - the sending and receiving domain ids and the tag
+        // - the number of merged iteration spaces, and for each merged iteration space
+        //   - the number of original iteration spaces and their indices
+        std::map<int, std::vector<char>> messages;
+        for (auto& p : pc)
+        {
+            for (auto& id_is_pair : p.recv_halos())
+            {
+                const auto n = id_is_pair.second.size();
+                const auto members = detail::coalesce(id_is_pair.second);
+                if (members.size() == n) continue;
+                removed += n - members.size();
+                auto& msg = messages[id_is_pair.first.mpi_rank];
+                write_bytes(msg, id_is_pair.first.id);
+                write_bytes(msg, p.domain_id());
+                write_bytes(msg, id_is_pair.first.tag);
+                write_bytes(msg, static_cast<int>(members.size()));
+                for (const auto& m : members)
+                {
+                    write_bytes(msg, static_cast<int>(m.size()));
+                    write_bytes(msg, m.data(), m.size());
+                }
+            }
+        }
+
+        // merge the send halos accordingly
+        auto comm = tl::mpi::setup_communicator(context.mpi_comm());
+        for (const auto& r : comm.sparse_exchange(messages, 0))
+        {
+            const char* ptr = r.second.data();
+            const char* end = ptr + r.second.size();
+            while (ptr != end)
+            {
+                domain_id_type send_id, recv_id;
+                int tag, num_spaces;
+                read_bytes(ptr, send_id);
+                read_bytes(ptr, recv_id);
+                read_bytes(ptr, tag);
+                read_bytes(ptr, num_spaces);
+                std::vector<std::vector<int>> members(num_spaces);
+                for (auto& m : members)
+                {
+                    int num_members;
+                    read_bytes(ptr, num_members);
+                    m.resize(num_members);
+                    read_bytes(ptr, m.data(), m.size());
+                }
+                auto p_it = std::find_if(pc.begin(), pc.end(),
+                    [send_id](const auto& p) { return p.domain_id() == send_id; });
+                if (p_it == pc.end())
+                    throw std::runtime_error("coalesce_pattern: send and receive halos are inconsistent");
+                auto h_it = std::find_if(p_it->send_halos().begin(), p_it->send_halos().end(),
+                    [recv_id, tag](const auto& h) { return h.first.id == recv_id && h.first.tag == tag; });
+                if (h_it == p_it->send_halos().end())
+                    throw std::runtime_error("coalesce_pattern: send and receive halos are inconsistent");
+                removed += h_it->second.size() - members.size();
+                detail::coalesce(h_it->second, members);
+            }
+        }
+        return removed;
+    }
+
+    } // namespace structured
+    } // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_PATTERN_COALESCE_HPP */
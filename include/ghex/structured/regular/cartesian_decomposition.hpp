@@ -0,0 +1,252 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_REGULAR_CARTESIAN_DECOMPOSITION_HPP
+#define INCLUDED_GHEX_STRUCTURED_REGULAR_CARTESIAN_DECOMPOSITION_HPP
+
+#include <mpi.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../../util/decomposition.hpp"
+#include "../../transport_layer/mpi/error.hpp"
+#include "./domain_descriptor.hpp"
+
+namespace gridtools {
+    namespace ghex {
+    namespace structured {
+    namespace regular {
+
+    /** @brief describes a decomposition of a structured global domain into a Cartesian grid of domains. The
+     * domain boundaries are given by one list of offsets per dimension, such that the extents, owning rank and
+     * id of every domain can be computed locally. The object is also a range of the domains of this rank and
+     * can be passed to make_pattern in place of a domain range. Together with a regular halo generator,
+     * make_pattern then computes the halos of the neighbors analytically, without all-gathering the domains.
+     *
+     * Domains are addressed by their position in the grid of domains. Domain ids are the indices of the
+     * domains in the decomposition, i.e. the rank for one domain per rank.
+     * @tparam Dimension dimension of domain*/
+    template<int Dimension>
+    class cartesian_decomposition
+    {
+    public: // member types
+        using domain_id_type  = int;
+        using domain_type     = domain_descriptor<domain_id_type,Dimension>;
+        using value_type      = domain_type;
+        using dimension       = typename domain_type::dimension;
+        using coordinate_type = typename domain_type::coordinate_type;
+        // position of a domain in the grid of domains
+        using position_type   = std::array<int,dimension::value>;
+        // per dimension: first global coordinate of each slab of domains, followed by the last coordinate + 1
+        using offsets_type    = std::array<std::vector<int>,dimension::value>;
+
+    private: // members
+        offsets_type                              m_offsets;
+        int                                       m_domains_per_rank;
+        std::function<int(const position_type&)>  m_index;
+        std::function<position_type(int)>         m_position;
+        std::vector<domain_type>                  m_domains;
+
+    public: // ctors
+        /** @brief construct from a Cartesian MPI communicator with one domain per rank
+         * @param comm Cartesian communicator (ranks are numbered in row-major order of the grid positions)
+         * @param offsets domain boundaries per dimension (dims[d]+1 entries for dimension d) */
+        cartesian_decomposition(MPI_Comm comm, const offsets_type& offsets)
+        : m_offsets(offsets)
+        , m_domains_per_rank{1}
+        {
+            const auto d_map = cart_map(comm);
+            m_index    = [d_map](const position_type& pos) { return d_map.index(pos); };
+            m_position = [d_map](int idx) { return d_map(idx); };
+            init(comm);
+        }
+
+        /** @brief construct from a Cartesian MPI communicator with one domain per rank, where every rank only
+         * knows its own extents. The extents are gathered along the axes of the processor grid, such that all
+         * ranks in a slab must agree on the extent of the slab.
+         * @param comm Cartesian communicator (ranks are numbered in row-major order of the grid positions)
+         * @param local_extents extents of this rank's domain */
+        cartesian_decomposition(MPI_Comm comm, const coordinate_type& local_extents)
+        : m_domains_per_rank{1}
+        {
+            const auto d_map = cart_map(comm);
+            m_index    = [d_map](const position_type& pos) { return d_map.index(pos); };
+            m_position = [d_map](int idx) { return d_map(idx); };
+            for (int d=0; d<dimension::value; ++d)
+            {
+                int remain_dims[dimension::value] = {};
+                remain_dims[d] = 1;
+                MPI_Comm axis;
+                GHEX_CHECK_MPI_RESULT(MPI_Cart_sub(comm, remain_dims, &axis));
+                std::vector<int> extents(d_map.dims()[d]);
+                GHEX_CHECK_MPI_RESULT(MPI_Allgather(&local_extents[d], 1, MPI_INT, extents.data(), 1, MPI_INT, axis));
+                GHEX_CHECK_MPI_RESULT(MPI_Comm_free(&axis));
+                m_offsets[d].resize(extents.size()+1, 0);
+                std::partial_sum(extents.begin(), extents.end(), m_offsets[d].begin()+1);
+            }
+            init(comm);
+        }
+
+        /** @brief construct from a hierarchical decomposition with threads_per_rank() domains per rank
+         * @param comm communicator
+         * @param decomposition hierarchical decomposition (domain index = rank*threads_per_rank() + thread index)
+         * @param offsets domain boundaries per dimension (last_coord()[d]+2 entries for dimension d) */
+        cartesian_decomposition(MPI_Comm comm, const hierarchical_decomposition<Dimension>& decomposition,
+            const offsets_type& offsets)
+        : m_offsets(offsets)
+        , m_domains_per_rank(decomposition.threads_per_rank())
+        , m_index{[decomposition](const position_type& pos) { return decomposition.domain_index(pos); }}
+        , m_position{[decomposition](int idx) { return decomposition(idx); }}
+        {
+            init(comm);
+        }
+
+        cartesian_decomposition(const cartesian_decomposition&) = default;
+        cartesian_decomposition(cartesian_decomposition&&) = default;
+
+    public: // member functions
+        /** @brief number of domains per dimension */
+        position_type dims() const noexcept
+        {
+            position_type res;
+            for (int d=0; d<dimension::value; ++d) res[d] = m_offsets[d].size()-1;
+            return res;
+        }
+        /** @brief first coordinate of the global domain */
+        coordinate_type global_first() const noexcept
+        {
+            coordinate_type res;
+            for (int d=0; d<dimension::value; ++d) res[d] = m_offsets[d].front();
+            return res;
+        }
+        /** @brief last coordinate of the global domain (including) */
+        coordinate_type global_last() const noexcept
+        {
+            coordinate_type res;
+            for (int d=0; d<dimension::value; ++d) res[d] = m_offsets[d].back()-1;
+            return res;
+        }
+        /** @brief number of domains per rank */
+        int domains_per_rank() const noexcept { return m_domains_per_rank; }
+
+        /** @brief rank owning the domain at a grid position */
+        int rank(const position_type& pos) const { return m_index(pos)/m_domains_per_rank; }
+        /** @brief id of the domain at a grid position */
+        domain_id_type domain_id(const position_type& pos) const { return m_index(pos); }
+        /** @brief domain descriptor of the domain at a grid position */
+        domain_type domain(const position_type& pos) const
+        {
+            coordinate_type first, last;
+            for (int d=0; d<dimension::value; ++d)
+            {
+                first[d] = m_offsets[d][pos[d]];
+                last[d]  = m_offsets[d][pos[d]+1]-1;
+            }
+            return {domain_id(pos), first, last};
+        }
+        /** @brief grid positions of the domains of a rank (in the order of the rank's domains) */
+        std::vector<position_type> positions(int rank) const
+        {
+            std::vector<position_type> res;
+            for (int i=0; i<m_domains_per_rank; ++i)
+                res.push_back(m_position(rank*m_domains_per_rank+i));
+            return res;
+        }
+
+        /** @brief visit the grid positions of all domains which overlap a box (clipped to the global domain)
+         * @tparam Coordinate coordinate-like type
+         * @tparam Func function object with signature void(const position_type&)
+         * @param first first coordinate of the box
+         * @param last last coordinate of the box (including)
+         * @param f function object */
+        template<typename Coordinate, typename Func>
+        void for_each_overlapping(const Coordinate& first, const Coordinate& last, Func&& f) const
+        {
+            position_type lo, hi;
+            for (int d=0; d<dimension::value; ++d)
+            {
+                const auto& o = m_offsets[d];
+                const int a = std::max<int>(first[d], o.front());
+                const int b = std::min<int>(last[d], o.back()-1);
+                if (a > b) return;
+                lo[d] = std::upper_bound(o.begin(), o.end(), a) - o.begin() - 1;
+                hi[d] = std::upper_bound(o.begin(), o.end(), b) - o.begin() - 1;
+            }
+            auto pos = lo;
+            while (true)
+            {
+                f(pos);
+                int d = 0;
+                for (; d<dimension::value; ++d)
+                {
+                    if (++pos[d] <= hi[d]) break;
+                    pos[d] = lo[d];
+                }
+                if (d == dimension::value) break;
+            }
+        }
+
+        // range of the domains of this rank
+        std::size_t size() const noexcept { return m_domains.size(); }
+        auto begin() const noexcept { return m_domains.cbegin(); }
+        auto end() const noexcept { return m_domains.cend(); }
+
+    private: // implementation
+        // row-major numbering of the positions of a Cartesian communicator
+        static dims_map<Dimension> cart_map(MPI_Comm comm)
+        {
+            int ndims;
+            GHEX_CHECK_MPI_RESULT(MPI_Cartdim_get(comm, &ndims));
+            if (ndims != dimension::value)
+                throw std::runtime_error("cartesian_decomposition: communicator has the wrong number of dimensions");
+            int dims[dimension::value], periods[dimension::value], coords[dimension::value];
+            GHEX_CHECK_MPI_RESULT(MPI_Cart_get(comm, dimension::value, dims, periods, coords));
+            typename dims_map<Dimension>::array_type a;
+            std::copy(dims, dims+dimension::value, a.begin());
+            return {a, true};
+        }
+
+        void init(MPI_Comm comm)
+        {
+            int size, rank;
+            GHEX_CHECK_MPI_RESULT(MPI_Comm_size(comm, &size));
+            GHEX_CHECK_MPI_RESULT(MPI_Comm_rank(comm, &rank));
+            std::size_t num_domains = 1;
+            for (int d=0; d<dimension::value; ++d)
+            {
+                if (m_offsets[d].size() < 2 || !std::is_sorted(m_offsets[d].begin(), m_offsets[d].end()))
+                    throw std::runtime_error("cartesian_decomposition: offsets must be increasing");
+                num_domains *= m_offsets[d].size()-1;
+            }
+            if (num_domains != static_cast<std::size_t>(size)*m_domains_per_rank)
+                throw std::runtime_error("cartesian_decomposition: number of domains does not match the communicator");
+            for (const auto& pos : positions(rank))
+                m_domains.push_back(domain(pos));
+        }
+    };
+
+    template<typename T>
+    struct is_cartesian_decomposition : public std::false_type {};
+
+    template<int Dimension>
+    struct is_cartesian_decomposition<cartesian_decomposition<Dimension>> : public std::true_type {};
+
+    } // namespace regular
+    } // namespace structured
+    } // namespace ghex
+
+} // namespac gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_REGULAR_CARTESIAN_DECOMPOSITION_HPP */
@@ -14,10 +14,13 @@
 #include "../field_descriptor.hpp"
 #include "../field_utils.hpp"
 #include "../pack_kernels.hpp"
+#include "../rma_put.hpp"
+#include "../static_halos.hpp"
 #include "./domain_descriptor.hpp"
 #include <cstring>
 #include <cstdint>
 #include "../../arch_traits.hpp"
+#include "../../transport_layer/mpi/error.hpp"
 
 //#define NCTIS 128
 
@@ -26,6 +29,18 @@ namespace ghex {
 namespace structured {    
 namespace regular {
 
+namespace detail {
+// canonical wire layout: the components (if any) vary fastest, followed by dimension 0, 1, ...
+template<typename Seq, bool HasComponents>
+struct canonical_layout;
+template<std::size_t... Is, bool HasComponents>
+struct canonical_layout<std::index_sequence<Is...>, HasComponents> {
+    static constexpr int D = sizeof...(Is);
+    using type = ::gridtools::layout_map<
+        (HasComponents ? ((int)Is == D-1 ? D-1 : D-2-(int)Is) : D-1-(int)Is)...>;
+};
+} // namespace detail
+
 template<typename T, typename Arch, typename DomainDescriptor, int... Order>
 class field_descriptor
 : public gridtools::ghex::structured::field_descriptor<T,Arch,DomainDescriptor,Order...>
@@ -47,6 +62,9 @@ public: // member types
     using serialization_type       = gridtools::ghex::structured::serialization<arch_type,layout_map>;
     using pack_iteration_space     = typename base::pack_iteration_space;
     using unpack_iteration_space   = typename base::unpack_iteration_space;
+    using canonical_layout_map     = typename detail::canonical_layout<
+        std::make_index_sequence<dimension::value>, has_components::value>::type;
+    using static_halos_type        = static_halos<>; // runtime halo widths
 
     template<typename OtherArch>
     using rebind_arch = field_descriptor<T,OtherArch,DomainDescriptor,Order...>;
@@ -82,24 +100,98 @@ public: // ctors
 
     template<typename IndexContainer>
     void pack(T* buffer, const IndexContainer& c, void* arg) {
-        // loop over pattern's iteration spaces
-        for (const auto& is : c) {
-            // number of values to pack
-            const size_type size = is.size()*base::num_components();
-            serialization_type::pack_batch( make_pack_is(is,buffer,size), arg );
-            buffer += size;
-        }
+        pack_impl(buffer, c, arg, static_halos<>{});
     }
     
     template<typename IndexContainer>
     void unpack(const T* buffer, const IndexContainer& c, void* arg) {
-        // loop over pattern's iteration spaces
-        for (const auto& is : c) {
-            // number of values to pack
-            const size_type size = is.size()*base::num_components();
-            serialization_type::unpack_batch( make_unpack_is(is,buffer,size), arg );
-            buffer += size;
+        unpack_impl(buffer, c, arg, static_halos<>{});
+    }
+
+    /** @brief serialize this field in the canonical wire layout (components varying fastest, followed by
+      * dimension 0, 1, ...) instead of its memory layout. Fields with different memory layouts (e.g. planar and
+      * interleaved components) can exchange halos if both use the canonical wire layout. Packing and unpacking
+      * then transpose the data in tiles, traversing the field memory in its own order.
+      * @param flag enable or disable the canonical wire layout
+      * @return reference to this field */
+    field_descriptor& use_canonical_wire_layout(bool flag = true) noexcept {
+        m_canonical_wire = flag;
+        return *this;
+    }
+
+    /** @brief returns true if the field is serialized in the canonical wire layout */
+    bool canonical_wire_layout() const noexcept { return m_canonical_wire; }
+
+    /** @brief returns a pointer to the first element of an iteration space if the iteration space occupies a
+      * contiguous memory region with the same element order as the serialized buffer, and nullptr otherwise.
+      * Data of such iteration spaces can be sent and received without intermediate buffer.
+      * @tparam IterationSpace iteration space type
+      * @param is iteration space
+      * @return pointer to field memory or nullptr */
+    template<typename IterationSpace>
+    value_type* contiguous_ptr(const IterationSpace& is) noexcept {
+        coordinate_type first;
+        coordinate_type last;
+        local_range(is, first, last);
+        // check strides from the fastest to the slowest varying dimension
+        size_type stride = sizeof(value_type);
+        for (int i=dimension::value-1; i>=0; --i) {
+            const auto d = wire_dim(i);
+            const size_type ext = last[d]-first[d]+1;
+            if (ext == 1u) continue;
+            if (base::m_byte_strides[d] != stride) return nullptr;
+            stride *= ext;
         }
+        return base::ptr(first);
+    }
+
+    /** @brief creates an MPI datatype which describes the field memory of an iteration space. The element order
+      * is the same as in the serialized buffer. The datatype holds absolute addresses (use with MPI_BOTTOM), is not
+      * committed and must be freed by the caller.
+      * @tparam IterationSpace iteration space type
+      * @param is iteration space
+      * @return MPI datatype */
+    template<typename IterationSpace>
+    MPI_Datatype mpi_datatype(const IterationSpace& is) {
+        coordinate_type first;
+        coordinate_type last;
+        local_range(is, first, last);
+        // nest strided vectors from the fastest to the slowest varying dimension
+        MPI_Datatype t;
+        GHEX_CHECK_MPI_RESULT(MPI_Type_contiguous(sizeof(value_type), MPI_BYTE, &t));
+        for (int i=dimension::value-1; i>=0; --i) {
+            const auto d = wire_dim(i);
+            MPI_Datatype v;
+            GHEX_CHECK_MPI_RESULT(MPI_Type_create_hvector(last[d]-first[d]+1, 1,
+                static_cast<MPI_Aint>(base::m_byte_strides[d]), t, &v));
+            GHEX_CHECK_MPI_RESULT(MPI_Type_free(&t));
+            t = v;
+        }
+        // place at the absolute address of the first element
+        MPI_Aint address;
+        GHEX_CHECK_MPI_RESULT(MPI_Get_address(base::ptr(first), &address));
+        int block_length = 1;
+        MPI_Datatype res;
+        GHEX_CHECK_MPI_RESULT(MPI_Type_create_struct(1, &block_length, &address, &t, &res));
+        GHEX_CHECK_MPI_RESULT(MPI_Type_free(&t));
+        return res;
+    }
+
+    /** @brief copies the values of an iteration space directly into the corresponding iteration space of another
+      * field (same-rank neighbor), bypassing the serialized buffer.
+      * @tparam IterationSpace iteration space type
+      * @param dst destination field
+      * @param src_is iteration space in this field
+      * @param dst_is iteration space in the destination field (same shape as src_is) */
+    template<typename IterationSpace>
+    void copy_to(field_descriptor& dst, const IterationSpace& src_is, const IterationSpace& dst_is) {
+        rma_range<field_descriptor> s{*this, src_is.local().first(), src_is.local().last()-src_is.local().first()+1};
+        rma_range<field_descriptor> t{dst, dst_is.local().first(), dst_is.local().last()-dst_is.local().first()+1};
+#ifdef __CUDACC__
+        ::gridtools::ghex::structured::put(s, t, nullptr);
+#else
+        ::gridtools::ghex::structured::put(s, t);
+#endif
     }
 
     template<typename IterationSpace>
@@ -114,7 +206,129 @@ public: // ctors
                 make_is<typename base::template basic_iteration_space<T*>>(is)};
     }
 
+    /** @brief pack several fields of this type in one traversal of the iteration spaces. The fields are
+      * accessed through fields(k) and their buffers through buffers(k), k=0,...,n-1. If all fields share the
+      * memory layout of the first field, the index computations are done once for all fields, otherwise the
+      * fields are packed one after the other.
+      * @tparam IndexContainer iteration space container type
+      * @param n number of fields
+      * @param fields functor returning a reference to field k
+      * @param buffers functor returning the buffer of field k
+      * @param c iteration spaces */
+    template<typename IndexContainer, typename Fields, typename Buffers>
+    static void pack_fused(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c) {
+        pack_fused_impl(n, std::forward<Fields>(fields), std::forward<Buffers>(buffers), c, static_halos<>{});
+    }
+
+    /** @brief unpack several fields of this type in one traversal of the iteration spaces (see pack_fused) */
+    template<typename IndexContainer, typename Fields, typename Buffers>
+    static void unpack_fused(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c) {
+        unpack_fused_impl(n, std::forward<Fields>(fields), std::forward<Buffers>(buffers), c, static_halos<>{});
+    }
+
+protected: // serialization
+    // pack/unpack with the kernels instantiated for the static halo widths StaticHalos
+    template<typename IndexContainer, typename StaticHalos>
+    void pack_impl(T* buffer, const IndexContainer& c, void* arg, StaticHalos halos) {
+        // loop over pattern's iteration spaces
+        for (const auto& is : c) {
+            // number of values to pack
+            const size_type size = is.size()*base::num_components();
+            if (transposed_wire())
+                serialization_type::pack_transposed( make_pack_is(is,buffer,size), arg );
+            else
+                serialization_type::pack_batch( make_pack_is(is,buffer,size), arg, halos );
+            buffer += size;
+        }
+    }
+
+    template<typename IndexContainer, typename StaticHalos>
+    void unpack_impl(const T* buffer, const IndexContainer& c, void* arg, StaticHalos halos) {
+        // loop over pattern's iteration spaces
+        for (const auto& is : c) {
+            // number of values to pack
+            const size_type size = is.size()*base::num_components();
+            if (transposed_wire())
+                serialization_type::unpack_transposed( make_unpack_is(is,buffer,size), arg );
+            else
+                serialization_type::unpack_batch( make_unpack_is(is,buffer,size), arg, halos );
+            buffer += size;
+        }
+    }
+
+    template<typename IndexContainer, typename Fields, typename Buffers, typename StaticHalos>
+    static void pack_fused_impl(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c,
+        StaticHalos halos) {
+        auto& f_0 = fields(0);
+        if (!f_0.same_layout(n, fields)) {
+            for (std::size_t k=0; k<n; ++k) fields(k).pack(buffers(k), c, nullptr);
+            return;
+        }
+        std::size_t pos = 0;
+        for (const auto& is : c) {
+            const size_type size = is.size()*f_0.num_components();
+            serialization_type::pack_batch_fused(f_0.make_pack_is(is, buffers(0)+pos, size), n,
+                [&fields](std::size_t k) { return reinterpret_cast<const char*>(fields(k).data()); },
+                [&buffers,pos](std::size_t k) { return reinterpret_cast<char*>(buffers(k)+pos); }, halos);
+            pos += size;
+        }
+    }
+
+    template<typename IndexContainer, typename Fields, typename Buffers, typename StaticHalos>
+    static void unpack_fused_impl(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c,
+        StaticHalos halos) {
+        auto& f_0 = fields(0);
+        if (!f_0.same_layout(n, fields)) {
+            for (std::size_t k=0; k<n; ++k) fields(k).unpack(buffers(k), c, nullptr);
+            return;
+        }
+        std::size_t pos = 0;
+        for (const auto& is : c) {
+            const size_type size = is.size()*f_0.num_components();
+            serialization_type::unpack_batch_fused(f_0.make_unpack_is(is, buffers(0)+pos, size), n,
+                [&fields](std::size_t k) { return reinterpret_cast<char*>(fields(k).data()); },
+                [&buffers,pos](std::size_t k) { return reinterpret_cast<const char*>(buffers(k)+pos); }, halos);
+            pos += size;
+        }
+    }
+
 private: // implementation
+    // true if the wire layout differs from the memory layout
+    bool transposed_wire() const noexcept {
+        return m_canonical_wire && !std::is_same<layout_map, canonical_layout_map>::value;
+    }
+
+    // dimension with the i-th smallest stride in the serialized buffer
+    int wire_dim(int i) const noexcept {
+        return m_canonical_wire ? canonical_layout_map::find(i) : layout_map::find(i);
+    }
+
+    // local coordinate range of an iteration space, including the component dimension
+    template<typename IterationSpace>
+    void local_range(const IterationSpace& is, coordinate_type& first, coordinate_type& last) const noexcept {
+        std::copy(is.local().first().begin(), is.local().first().end(), first.begin());
+        std::copy(is.local().last().begin(), is.local().last().end(), last.begin());
+        if (has_components::value) {
+            first[dimension::value-1] = 0;
+            last[dimension::value-1] = base::m_num_components-1;
+        }
+    }
+
+    // true if the fields 0,...,n-1 have the same offsets, strides and number of components as this field and
+    // are serialized in their memory layout
+    template<typename Fields>
+    bool same_layout(std::size_t n, Fields&& fields) const noexcept {
+        for (std::size_t k=0; k<n; ++k) {
+            const auto& f = fields(k);
+            if (f.transposed_wire()) return false;
+            if (f.num_components() != base::num_components()) return false;
+            for (std::size_t i=0; i<dimension::value; ++i)
+                if (f.offsets()[i] != base::m_offsets[i] || f.byte_strides()[i] != base::m_byte_strides[i])
+                    return false;
+        }
+        return true;
+    }
+
     template<typename BufferDesc, typename IterationSpace, typename Buffer>
     BufferDesc make_buffer_desc(const IterationSpace& is, Buffer buffer, size_type size) {
         // description of the halo in the buffer
@@ -125,11 +339,15 @@ private: // implementation
         coordinate_type buffer_extents;
         std::copy(is.global().last().begin(), is.global().last().end(), buffer_extents.begin()); 
         if (has_components::value)
-            buffer_extents[dimension::value-1] = base::m_num_components;
+            buffer_extents[dimension::value-1] = base::m_num_components-1;
         buffer_extents = buffer_extents - buffer_offset+1;
         strides_type buffer_strides;
-        ::gridtools::ghex::structured::detail::compute_strides<dimension::value>::template
-            apply<layout_map,value_type>(buffer_extents,buffer_strides,0u);
+        if (m_canonical_wire)
+            ::gridtools::ghex::structured::detail::compute_strides<dimension::value>::template
+                apply<canonical_layout_map,value_type>(buffer_extents,buffer_strides,0u);
+        else
+            ::gridtools::ghex::structured::detail::compute_strides<dimension::value>::template
+                apply<layout_map,value_type>(buffer_extents,buffer_strides,0u);
         return {buffer, buffer_offset, buffer_strides, size};
     }
 
@@ -151,6 +369,59 @@ private: // implementation
         return {base::m_data, base::m_dom_first, base::m_offsets,
                 data_first, data_last, base::m_byte_strides, local_strides};
     }
+
+private: // members
+    bool m_canonical_wire = false;
+};
+
+/** @brief field descriptor with compile-time halo widths. Halo regions whose extents match the widths are packed
+  * and unpacked on the host by kernels instantiated for these widths (see cpu_kernels::gather_static), all other
+  * halo regions by the generic kernels. Patterns of a halo generator with static halos only accept fields with
+  * the same static_halos (see static_halo_pattern_container).
+  * @tparam StaticHalos static_halos<...> with two widths per dimension of the domain */
+template<typename StaticHalos, typename T, typename Arch, typename DomainDescriptor, int... Order>
+class static_halo_field_descriptor
+: public field_descriptor<T,Arch,DomainDescriptor,Order...>
+{
+    static_assert(is_static_halos<StaticHalos>::value, "StaticHalos must be an instance of static_halos");
+    static_assert(StaticHalos::size == 2*DomainDescriptor::dimension::value,
+        "static_halos requires two widths per dimension");
+
+public: // member types
+    using base              = field_descriptor<T,Arch,DomainDescriptor,Order...>;
+    using static_halos_type = StaticHalos;
+
+    template<typename OtherArch>
+    using rebind_arch = static_halo_field_descriptor<StaticHalos,T,OtherArch,DomainDescriptor,Order...>;
+
+public: // ctors
+    using base::base;
+
+public: // member functions
+    template<typename IndexContainer>
+    void pack(T* buffer, const IndexContainer& c, void* arg) {
+        base::pack_impl(buffer, c, arg, StaticHalos{});
+    }
+
+    template<typename IndexContainer>
+    void unpack(const T* buffer, const IndexContainer& c, void* arg) {
+        base::unpack_impl(buffer, c, arg, StaticHalos{});
+    }
+
+    static_halo_field_descriptor& use_canonical_wire_layout(bool flag = true) noexcept {
+        base::use_canonical_wire_layout(flag);
+        return *this;
+    }
+
+    template<typename IndexContainer, typename Fields, typename Buffers>
+    static void pack_fused(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c) {
+        base::pack_fused_impl(n, std::forward<Fields>(fields), std::forward<Buffers>(buffers), c, StaticHalos{});
+    }
+
+    template<typename IndexContainer, typename Fields, typename Buffers>
+    static void unpack_fused(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c) {
+        base::unpack_fused_impl(n, std::forward<Fields>(fields), std::forward<Buffers>(buffers), c, StaticHalos{});
+    }
 };
 
 } // namespace regular
@@ -173,6 +444,26 @@ private: // implementation
     {
         return {dom, data, offsets, extents, 1, false, device_id};     
     }
+
+    /** @brief wrap a N-dimensional array (field) of contiguous memory with compile-time halo widths. The host
+     * pack/unpack kernels of the field are instantiated for these widths (see static_halo_field_descriptor).
+     * @tparam Arch device type the data lives on
+     * @tparam Order permutation of the set {0,...,N-1} indicating storage layout (N-1 -> stride=1)
+     * @tparam DomainDescriptor domain type
+     * @tparam T field value type
+     * @tparam Array coordinate-like type
+     * @tparam Halos halo widths (dim0_dir-, dim0_dir+, dim1_dir-, dim1_dir+, ...)
+     * @param dom local domain
+     * @param data pointer to data
+     * @param offsets coordinate of first physical coordinate (not buffer) from the orign of the wrapped N-dimensional array
+     * @param extents extent of the wrapped N-dimensional array (including buffer regions)
+     * @return wrapped field*/
+    template<typename Arch, int... Order, typename DomainDescriptor, typename T, typename Array, int... Halos>
+    structured::regular::static_halo_field_descriptor<structured::static_halos<Halos...>,T,Arch,DomainDescriptor,Order...>
+    wrap_field(const DomainDescriptor& dom, T* data, const Array& offsets, const Array& extents, structured::static_halos<Halos...>, typename arch_traits<Arch>::device_id_type device_id = 0)
+    {
+        return {dom, data, offsets, extents, 1, false, device_id};
+    }
 } // namespace ghex
 } // namespace gridtools
 
@@ -12,6 +12,8 @@
 #define INCLUDED_GHEX_STRUCTURED_REGULAR_HALO_GENERATOR_HPP
 
 #include "./domain_descriptor.hpp"
+#include "../static_halos.hpp"
+#include "../stencil_footprint.hpp"
 
 namespace gridtools {
     namespace ghex {
@@ -20,14 +22,19 @@ namespace gridtools {
 
     /** @brief halo generator for structured domains
      * @tparam DomainIdType domain id type
-     * @tparam Dimension dimension of domain*/
-    template<typename DomainIdType, int Dimension>
+     * @tparam Dimension dimension of domain
+     * @tparam StaticHalos void (halos are passed at construction) or static_halos<...> (compile-time halos: fields
+     * bound to the patterns must be wrapped with the same static_halos and are packed by kernels specialized for
+     * these widths) */
+    template<typename DomainIdType, int Dimension, typename StaticHalos = void>
     class halo_generator
     {
     public: // member types
         using domain_type     = domain_descriptor<DomainIdType,Dimension>;
         using dimension       = typename domain_type::dimension;
         using coordinate_type = typename grid::template type<domain_type>::coordinate_type;
+        using footprint_type  = stencil_footprint<Dimension>;
+        using static_halos_type = StaticHalos;
 
     private: // member types
         struct box
@@ -62,6 +69,7 @@ namespace gridtools {
         template<typename Array, typename RangeHalos, typename RangePeriodic>
         halo_generator(const Array& g_first, const Array& g_last, RangeHalos&& halos, RangePeriodic&& periodic)
         {
+            static_assert(std::is_same<StaticHalos,void>::value, "halos are given by the static_halos parameter");
             std::copy(std::begin(g_first), std::end(g_first), m_first.begin());
             std::copy(std::begin(g_last), std::end(g_last), m_last.begin());
             m_halos.fill(0);
@@ -70,14 +78,51 @@ namespace gridtools {
             std::copy(periodic.begin(), periodic.end(), m_periodic.begin());
         }
 
+        /** @brief construct a halo generator which only generates the halos in the directions of a stencil
+         * footprint
+         * @tparam Array coordinate-like type
+         * @tparam RangeHalos range type holding halos
+         * @tparam RangePeriodic range type holding periodicity info
+         * @param g_first first global coordinate of total domain (used for periodicity)
+         * @param g_last last global coordinate of total domain (including, used for periodicity)
+         * @param halos list of halo sizes (dim0_dir-, dim0_dir+, dim1_dir-, dim1_dir+, ...)
+         * @param periodic list of bools indicating periodicity per dimension (true, true, false, ...)
+         * @param footprint directions of the halos (e.g. footprint_type::faces() for star-shaped stencils) */
+        template<typename Array, typename RangeHalos, typename RangePeriodic>
+        halo_generator(const Array& g_first, const Array& g_last, RangeHalos&& halos, RangePeriodic&& periodic,
+            const footprint_type& footprint)
+        : halo_generator(g_first, g_last, std::forward<RangeHalos>(halos), std::forward<RangePeriodic>(periodic))
+        {
+            m_footprint = footprint;
+        }
+
         // construct without periodicity
         halo_generator(std::initializer_list<int> halos)
         {
+            static_assert(std::is_same<StaticHalos,void>::value, "halos are given by the static_halos parameter");
             m_halos.fill(0);
             m_periodic.fill(false);
             std::copy(halos.begin(), halos.end(), m_halos.begin());
         }
 
+        /** @brief construct a halo generator with compile-time halos
+         * @tparam Array coordinate-like type
+         * @tparam RangePeriodic range type holding periodicity info
+         * @param g_first first global coordinate of total domain (used for periodicity)
+         * @param g_last last global coordinate of total domain (including, used for periodicity)
+         * @param periodic list of bools indicating periodicity per dimension (true, true, false, ...) */
+        template<typename Array, typename RangePeriodic, typename S = StaticHalos,
+            typename = std::enable_if_t<!std::is_same<S,void>::value>>
+        halo_generator(const Array& g_first, const Array& g_last, RangePeriodic&& periodic)
+        {
+            static_assert(S::size == dimension::value*2, "static_halos requires two widths per dimension");
+            std::copy(std::begin(g_first), std::end(g_first), m_first.begin());
+            std::copy(std::begin(g_last), std::end(g_last), m_last.begin());
+            m_halos = S::values();
+            m_periodic.fill(true);
+            std::copy(periodic.begin(), periodic.end(), m_periodic.begin());
+        }
+
         /** @brief generate halos
          * @param dom local domain instance
          * @return vector of halos of type box2 */
@@ -116,7 +161,7 @@ namespace gridtools {
             decltype(outer_halos) halos;
             for (int j=0; j<static_cast<int>(outer_halos.size()); ++j)
             {
-                if (j==(::gridtools::ghex::detail::ct_pow(3,dimension::value)/2)) continue;
+                if (!m_footprint.contains(j)) continue;
                 if (outer_halos[j].local().last() >= outer_halos[j].local().first())
                     halos.push_back(outer_halos[j]);
             }
@@ -153,6 +198,13 @@ namespace gridtools {
             return {local_box, global_box};
         }
 
+        /** @brief halo sizes (dim0_dir-, dim0_dir+, dim1_dir-, dim1_dir+, ...) */
+        const std::array<int,dimension::value*2>& halos() const noexcept { return m_halos; }
+        /** @brief periodicity per dimension */
+        const std::array<bool,dimension::value>& periodic() const noexcept { return m_periodic; }
+        /** @brief directions of the generated halos */
+        const footprint_type& footprint() const noexcept { return m_footprint; }
+
     private: // member functions
         template<typename Box, typename Spaces>
         std::vector<Box> compute_spaces(const Spaces& spaces) const
@@ -198,6 +250,7 @@ namespace gridtools {
         coordinate_type m_last;
         std::array<int,dimension::value*2> m_halos;
         std::array<bool,dimension::value> m_periodic;
+        footprint_type m_footprint;
     };
 
     } // namespace regular
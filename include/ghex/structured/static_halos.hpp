@@ -0,0 +1,61 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_STATIC_HALOS_HPP
+#define INCLUDED_GHEX_STRUCTURED_STATIC_HALOS_HPP
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace gridtools {
+namespace ghex {
+namespace structured {
+
+/** @brief compile-time halo widths (dim0_dir-, dim0_dir+, dim1_dir-, dim1_dir+, ...). Used as parameter of
+  * regular halo generators and of fields wrapped with static halos: the host pack/unpack kernels of such fields
+  * are instantiated for these widths and are selected when the extents of a halo region match them.
+  * static_halos<> (no widths) denotes runtime halos.
+  * @tparam Halos halo widths */
+template<int... Halos>
+struct static_halos {
+    static_assert(sizeof...(Halos)%2 == 0, "static_halos requires two widths per dimension");
+    static constexpr std::size_t size = sizeof...(Halos);
+    static constexpr std::array<int, sizeof...(Halos)> values() noexcept { return {{Halos...}}; }
+};
+
+/** @brief true if T is an instance of static_halos */
+template<typename T>
+struct is_static_halos : public std::false_type {};
+template<int... Halos>
+struct is_static_halos<static_halos<Halos...>> : public std::true_type {};
+
+namespace detail {
+template<std::size_t N>
+constexpr int static_halo_at(const std::array<int,N>& halos, std::size_t i) noexcept { return halos[i]; }
+
+// halo widths (dir-, dir+) of dimension D, or no widths if D is not a halo dimension (e.g. components)
+template<typename StaticHalos, std::size_t D, bool = (2*D < StaticHalos::size)>
+struct static_halo_widths {
+    using type = std::integer_sequence<int>;
+};
+template<int... Halos, std::size_t D>
+struct static_halo_widths<static_halos<Halos...>, D, true> {
+    using type = std::integer_sequence<int,
+        static_halo_at(static_halos<Halos...>::values(), 2*D),
+        static_halo_at(static_halos<Halos...>::values(), 2*D+1)>;
+};
+} // namespace detail
+
+} // namespace structured
+} // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_STATIC_HALOS_HPP */
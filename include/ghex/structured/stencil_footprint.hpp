@@ -0,0 +1,113 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_STENCIL_FOOTPRINT_HPP
+#define INCLUDED_GHEX_STRUCTURED_STENCIL_FOOTPRINT_HPP
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+#include "../common/utils.hpp"
+
+namespace gridtools {
+namespace ghex {
+namespace structured {
+
+/** @brief the halo regions a stencil reads from, given as a subset of the neighbor directions. A direction is an
+  * offset in {-1,0,1} per dimension: faces have one non-zero offset, edges two, and so on. Halo generators only
+  * generate the halo boxes in the directions of the footprint.
+  * @tparam Dimension dimension of the domain */
+template<int Dimension>
+class stencil_footprint {
+public: // member types
+    using offset_type = std::array<int, Dimension>;
+
+    /** @brief number of directions (including the center) */
+    static constexpr int size = ::gridtools::ghex::detail::ct_pow(3, Dimension);
+
+private: // members
+    std::array<bool, size> m_directions;
+
+public: // ctors
+    /** @brief footprint of all directions (faces, edges and corners) */
+    stencil_footprint() noexcept {
+        m_directions.fill(true);
+        m_directions[size/2] = false;
+    }
+
+    /** @brief footprint of a user-supplied set of directions (the center is ignored)
+      * @tparam Offsets range type holding offset_type-like elements
+      * @param offsets list of directions */
+    template<typename Offsets>
+    explicit stencil_footprint(const Offsets& offsets) {
+        m_directions.fill(false);
+        for (const auto& o : offsets) {
+            offset_type x;
+            std::copy(std::begin(o), std::end(o), x.begin());
+            m_directions[index(x)] = true;
+        }
+        m_directions[size/2] = false;
+    }
+
+    stencil_footprint(std::initializer_list<offset_type> offsets)
+    : stencil_footprint(std::vector<offset_type>(offsets)) {}
+
+public: // static member functions
+    /** @brief footprint of the directions with at most n non-zero offsets */
+    static stencil_footprint order(int n) {
+        stencil_footprint res;
+        for (int i=0; i<size; ++i) {
+            int nonzero = 0;
+            for (int d=0, j=i; d<Dimension; ++d, j/=3)
+                if (j%3 != 1) ++nonzero;
+            if (nonzero > n) res.m_directions[i] = false;
+        }
+        return res;
+    }
+
+    /** @brief footprint of a star-shaped stencil */
+    static stencil_footprint faces() { return order(1); }
+    /** @brief footprint of a stencil reading from faces and edges, but not corners */
+    static stencil_footprint faces_and_edges() { return order(2); }
+    /** @brief footprint of a box-shaped stencil */
+    static stencil_footprint full() { return stencil_footprint(); }
+
+    /** @brief index of a direction in the order of the halo generator (dimension 0 varies slowest) */
+    static int index(const offset_type& o) {
+        int i = 0;
+        for (int d=0; d<Dimension; ++d) {
+            if (o[d] < -1 || o[d] > 1)
+                throw std::runtime_error("stencil footprint: offsets must be -1, 0 or 1");
+            i = i*3 + o[d] + 1;
+        }
+        return i;
+    }
+
+public: // member functions
+    /** @brief true if the direction with the given index is part of the footprint */
+    bool contains(int i) const noexcept { return m_directions[i]; }
+    /** @brief true if the direction is part of the footprint */
+    bool contains(const offset_type& o) const { return m_directions[index(o)]; }
+
+    /** @brief number of directions of the footprint */
+    int num_directions() const noexcept {
+        int n = 0;
+        for (bool b : m_directions) n += b ? 1 : 0;
+        return n;
+    }
+};
+
+} // namespace structured
+} // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_STENCIL_FOOTPRINT_HPP */
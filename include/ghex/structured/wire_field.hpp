@@ -0,0 +1,129 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_STRUCTURED_WIRE_FIELD_HPP
+#define INCLUDED_GHEX_STRUCTURED_WIRE_FIELD_HPP
+
+#include <algorithm>
+#include <type_traits>
+#include "../common/utils.hpp"
+#include "../common/bfloat16.hpp"
+#include "../arch_list.hpp"
+#include "./field_utils.hpp"
+
+namespace gridtools {
+namespace ghex {
+namespace structured {
+
+namespace detail {
+// element-wise conversion of a contiguous range (vectorizable loop)
+template<typename To, typename From>
+inline void convert(const From* __restrict src, To* __restrict dst, std::size_t n) noexcept {
+    for (std::size_t i=0; i<n; ++i) dst[i] = static_cast<To>(src[i]);
+}
+} // namespace detail
+
+/** @brief field adaptor which exchanges the halos of a structured field in a different (usually lower
+  * precision) wire type. Values are converted from the field's value type to the wire type while packing and
+  * converted back while unpacking, such that the messages shrink by sizeof(wire_type)/sizeof(field value type).
+  * The adaptor is used in place of the field when binding it to a pattern. Both sides of an exchange must use
+  * the same wire type for a field.
+  * @tparam Wire wire type (e.g. float or bfloat16)
+  * @tparam Field structured host field descriptor type */
+template<typename Wire, typename Field>
+class wire_field
+{
+public: // member types
+    using field_type               = Field;
+    using value_type               = Wire;
+    using field_value_type         = typename Field::value_type;
+    using arch_type                = typename Field::arch_type;
+    using device_id_type           = typename Field::device_id_type;
+    using domain_descriptor_type   = typename Field::domain_descriptor_type;
+    using domain_id_type           = typename Field::domain_id_type;
+    using dimension                = typename Field::dimension;
+    using layout_map               = typename Field::layout_map;
+    using has_components           = typename Field::has_components;
+    using coordinate_type          = typename Field::coordinate_type;
+
+    static_assert(std::is_same<arch_type, cpu>::value, "wire types are only supported for host fields");
+
+private: // members
+    Field m_field;
+
+public: // ctors
+    wire_field(const Field& f) : m_field{f} {}
+    wire_field(const wire_field&) = default;
+    wire_field(wire_field&&) = default;
+
+public: // member functions
+    /** @brief returns the adapted field */
+    Field& field() noexcept { return m_field; }
+    const Field& field() const noexcept { return m_field; }
+    device_id_type device_id() const { return m_field.device_id(); }
+    const domain_descriptor_type& domain() const { return m_field.domain(); }
+    domain_id_type domain_id() const noexcept { return m_field.domain_id(); }
+    int num_components() const noexcept { return m_field.num_components(); }
+
+    template<typename IndexContainer>
+    void pack(Wire* buffer, const IndexContainer& c, void*) {
+        for (const auto& is : c) {
+            for_each_row(is, [&buffer](field_value_type* row, std::size_t n) {
+                detail::convert(static_cast<const field_value_type*>(row), buffer, n);
+                buffer += n;
+            });
+        }
+    }
+
+    template<typename IndexContainer>
+    void unpack(const Wire* buffer, const IndexContainer& c, void*) {
+        for (const auto& is : c) {
+            for_each_row(is, [&buffer](field_value_type* row, std::size_t n) {
+                detail::convert(buffer, row, n);
+                buffer += n;
+            });
+        }
+    }
+
+private: // implementation
+    // visit the contiguous rows (along the fastest varying dimension) of an iteration space in a fixed order
+    template<typename IterationSpace, typename Func>
+    void for_each_row(const IterationSpace& is, Func&& f) {
+        static constexpr auto I = layout_map::find(dimension::value-1);
+        coordinate_type first;
+        coordinate_type last;
+        std::copy(is.local().first().begin(), is.local().first().end(), first.begin());
+        std::copy(is.local().last().begin(), is.local().last().end(), last.begin());
+        if (has_components::value) {
+            first[dimension::value-1] = 0;
+            last[dimension::value-1] = m_field.num_components()-1;
+        }
+        const std::size_t n = last[I]-first[I]+1;
+        ::gridtools::ghex::detail::for_loop<dimension::value, dimension::value, layout_map, 1>::apply(
+            [this,&f,n](auto... x) { f(m_field.ptr(coordinate_type{x...}), n); },
+            first, last);
+    }
+};
+
+/** @brief exchange the halos of a field in a different wire type
+  * @tparam Wire wire type
+  * @tparam Field field descriptor type
+  * @param f field
+  * @return field adaptor */
+template<typename Wire, typename Field>
+wire_field<Wire, Field> make_wire_field(const Field& f) {
+    return {f};
+}
+
+} // namespace structured
+} // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_STRUCTURED_WIRE_FIELD_HPP */
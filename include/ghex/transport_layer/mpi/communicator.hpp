@@ -16,6 +16,8 @@
 #include "../shared_message_buffer.hpp"
 #include "../tags.hpp"
 #include "./future.hpp"
+#include "./persistent_request.hpp"
+#include "./datatype.hpp"
 #include "./request_cb.hpp"
 #include "./communicator_state.hpp"
 
@@ -45,6 +47,7 @@ namespace gridtools {
                     using request_cb_type = request_cb;
                     using message_type    = typename request_cb_type::message_type;
                     using progress_status = typename state_type::progress_status;
+                    using persistent_request_set_type = persistent_request_set;
 
                   private: // members
                     shared_state_type* m_shared_state;
@@ -102,6 +105,70 @@ namespace gridtools {
                         return req;
                     }
 
+                    /** @brief send data described by a datatype with absolute addresses. The memory must be kept
+                     * alive by the caller until the communication is finished.
+                     * @param type a committed datatype
+                     * @param dst the destination rank
+                     * @param tag the communication tag
+                     * @return a future to test/wait for completion */
+                    [[nodiscard]] future<void> send_datatype(const datatype& type, rank_type dst, tag_type tag) {
+                        request req;
+                        GHEX_CHECK_MPI_RESULT(MPI_Isend(MPI_BOTTOM, 1, type.get(), dst, tag, m_shared_state->m_comm,
+                                                        &req.get()));
+                        req.m_kind = request_kind::send;
+                        return req;
+                    }
+
+                    /** @brief receive data described by a datatype with absolute addresses. The memory must be kept
+                     * alive by the caller until the communication is finished.
+                     * @param type a committed datatype
+                     * @param src the source rank
+                     * @param tag the communication tag
+                     * @return a future to test/wait for completion */
+                    [[nodiscard]] future<void> recv_datatype(const datatype& type, rank_type src, tag_type tag) {
+                        request req;
+                        GHEX_CHECK_MPI_RESULT(MPI_Irecv(MPI_BOTTOM, 1, type.get(), src, tag, m_shared_state->m_comm,
+                                                        &req.get()));
+                        req.m_kind = request_kind::recv;
+                        return req;
+                    }
+
+                    /** @brief create a persistent send request. The request is inactive and must be started
+                     * (e.g. through persistent_request_set::start_all) to send the message. The message must be kept
+                     * alive and must not be resized until the request is freed.
+                     * @tparam Message a meassage type
+                     * @param msg an l-value reference to the message to be sent
+                     * @param dst the destination rank
+                     * @param tag the communication tag
+                     * @return an inactive persistent request */
+                    template<typename Message>
+                    [[nodiscard]] request send_init(const Message& msg, rank_type dst, tag_type tag) {
+                        request req;
+                        GHEX_CHECK_MPI_RESULT(MPI_Send_init(reinterpret_cast<const void*>(msg.data()),
+                                                            sizeof(typename Message::value_type) * msg.size(), MPI_BYTE,
+                                                            dst, tag, m_shared_state->m_comm, &req.get()));
+                        req.m_kind = request_kind::send;
+                        return req;
+                    }
+
+                    /** @brief create a persistent receive request. The request is inactive and must be started
+                     * (e.g. through persistent_request_set::start_all) to receive the message. The message must be
+                     * kept alive and must not be resized until the request is freed.
+                     * @tparam Message a meassage type
+                     * @param msg an l-value reference to the message to be received
+                     * @param src the source rank
+                     * @param tag the communication tag
+                     * @return an inactive persistent request */
+                    template<typename Message>
+                    [[nodiscard]] request recv_init(Message& msg, rank_type src, tag_type tag) {
+                        request req;
+                        GHEX_CHECK_MPI_RESULT(MPI_Recv_init(reinterpret_cast<void*>(msg.data()),
+                                                            sizeof(typename Message::value_type) * msg.size(), MPI_BYTE,
+                                                            src, tag, m_shared_state->m_comm, &req.get()));
+                        req.m_kind = request_kind::recv;
+                        return req;
+                    }
+
                     /** @brief Function to poll the transport layer and check for completion of operations with an
                       * associated callback. When an operation completes, the corresponfing call-back is invoked
                       * with the message, rank and tag associated with this communication.
@@ -0,0 +1,76 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_TL_MPI_DATATYPE_HPP
+#define INCLUDED_GHEX_TL_MPI_DATATYPE_HPP
+
+#include <vector>
+#include "./error.hpp"
+
+namespace gridtools{
+    namespace ghex {
+        namespace tl {
+            namespace mpi {
+
+                /** @brief owning wrapper around a committed MPI datatype. The datatype is freed upon destruction. */
+                class datatype
+                {
+                private: // members
+                    MPI_Datatype m_type = MPI_DATATYPE_NULL;
+
+                public: // ctors
+                    datatype() noexcept = default;
+
+                    /** @brief combine a list of datatypes (with absolute addresses) into a single committed datatype.
+                      * Takes ownership of the datatypes in the list.
+                      * @param types list of datatypes */
+                    datatype(std::vector<MPI_Datatype>& types)
+                    {
+                        std::vector<int> block_lengths(types.size(), 1);
+                        std::vector<MPI_Aint> displacements(types.size(), 0);
+                        GHEX_CHECK_MPI_RESULT(MPI_Type_create_struct(static_cast<int>(types.size()),
+                            block_lengths.data(), displacements.data(), types.data(), &m_type));
+                        GHEX_CHECK_MPI_RESULT(MPI_Type_commit(&m_type));
+                        for (auto& t : types) GHEX_CHECK_MPI_RESULT(MPI_Type_free(&t));
+                        types.clear();
+                    }
+
+                    datatype(const datatype&) = delete;
+                    datatype& operator=(const datatype&) = delete;
+                    datatype(datatype&& other) noexcept : m_type{other.m_type} { other.m_type = MPI_DATATYPE_NULL; }
+                    datatype& operator=(datatype&& other) noexcept
+                    {
+                        free();
+                        m_type = other.m_type;
+                        other.m_type = MPI_DATATYPE_NULL;
+                        return *this;
+                    }
+                    ~datatype() { free(); }
+
+                public: // member functions
+                    MPI_Datatype get() const noexcept { return m_type; }
+
+                private: // implementation
+                    void free() noexcept
+                    {
+                        if (m_type == MPI_DATATYPE_NULL) return;
+                        int finalized = 0;
+                        MPI_Finalized(&finalized);
+                        if (!finalized) MPI_Type_free(&m_type);
+                        m_type = MPI_DATATYPE_NULL;
+                    }
+                };
+
+            } // namespace mpi
+        } // namespace tl
+    } // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_TL_MPI_DATATYPE_HPP */
@@ -0,0 +1,170 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef INCLUDED_GHEX_TL_MPI_PERSISTENT_REQUEST_HPP
+#define INCLUDED_GHEX_TL_MPI_PERSISTENT_REQUEST_HPP
+
+#include <vector>
+#include "./request.hpp"
+
+namespace gridtools{
+    namespace ghex {
+        namespace tl {
+            namespace mpi {
+
+                /** @brief owns a set of persistent MPI requests (created through MPI_Send_init/MPI_Recv_init) which
+                  * can be started and completed repeatedly. The requests are freed upon destruction. */
+                class persistent_request_set
+                {
+                private: // members
+                    std::vector<MPI_Request> m_reqs;
+                    std::vector<int> m_indices;
+                    int m_num_active = 0;
+
+                public: // ctors
+                    persistent_request_set() noexcept = default;
+                    persistent_request_set(const persistent_request_set&) = delete;
+                    persistent_request_set& operator=(const persistent_request_set&) = delete;
+                    persistent_request_set(persistent_request_set&& other) noexcept
+                    : m_reqs{std::move(other.m_reqs)}
+                    , m_indices{std::move(other.m_indices)}
+                    , m_num_active{other.m_num_active}
+                    {
+                        other.m_reqs.clear();
+                        other.m_num_active = 0;
+                    }
+                    persistent_request_set& operator=(persistent_request_set&& other) noexcept
+                    {
+                        free();
+                        m_reqs = std::move(other.m_reqs);
+                        m_indices = std::move(other.m_indices);
+                        m_num_active = other.m_num_active;
+                        other.m_reqs.clear();
+                        other.m_num_active = 0;
+                        return *this;
+                    }
+                    ~persistent_request_set() { free(); }
+
+                public: // member functions
+                    std::size_t size() const noexcept { return m_reqs.size(); }
+                    bool empty() const noexcept { return m_reqs.empty(); }
+                    int num_active() const noexcept { return m_num_active; }
+
+                    /** @brief take ownership of an inactive persistent request
+                      * @param req request returned by communicator::send_init or communicator::recv_init
+                      * @return index of the request within this set */
+                    std::size_t push_back(request_t&& req)
+                    {
+                        m_reqs.push_back(req.get());
+                        req.get() = MPI_REQUEST_NULL;
+                        m_indices.resize(m_reqs.size());
+                        return m_reqs.size()-1;
+                    }
+
+                    /** @brief start all requests in this set */
+                    void start_all()
+                    {
+                        if (m_reqs.empty()) return;
+                        GHEX_CHECK_MPI_RESULT(MPI_Startall(static_cast<int>(m_reqs.size()), m_reqs.data()));
+                        m_num_active = static_cast<int>(m_reqs.size());
+                    }
+
+                    /** @brief wait for at least one active request to complete and call a continuation with the
+                      * index of each completed request.
+                      * @tparam Continuation function object with signature void(std::size_t)
+                      * @param cont continuation
+                      * @return number of completed requests */
+                    template<typename Continuation>
+                    int wait_some(Continuation&& cont)
+                    {
+                        if (m_num_active == 0) return 0;
+                        int outcount = 0;
+                        GHEX_CHECK_MPI_RESULT(MPI_Waitsome(static_cast<int>(m_reqs.size()), m_reqs.data(),
+                            &outcount, m_indices.data(), MPI_STATUSES_IGNORE));
+                        if (outcount == MPI_UNDEFINED)
+                        {
+                            m_num_active = 0;
+                            return 0;
+                        }
+                        m_num_active -= outcount;
+                        for (int i=0; i<outcount; ++i) cont(static_cast<std::size_t>(m_indices[i]));
+                        return outcount;
+                    }
+
+                    /** @brief test the active requests without blocking and call a continuation with the index of
+                      * each completed request.
+                      * @tparam Continuation function object with signature void(std::size_t)
+                      * @param cont continuation
+                      * @return true if no request is active anymore */
+                    template<typename Continuation>
+                    bool test_some(Continuation&& cont)
+                    {
+                        if (m_num_active == 0) return true;
+                        int outcount = 0;
+                        GHEX_CHECK_MPI_RESULT(MPI_Testsome(static_cast<int>(m_reqs.size()), m_reqs.data(),
+                            &outcount, m_indices.data(), MPI_STATUSES_IGNORE));
+                        if (outcount == MPI_UNDEFINED)
+                        {
+                            m_num_active = 0;
+                            return true;
+                        }
+                        m_num_active -= outcount;
+                        for (int i=0; i<outcount; ++i) cont(static_cast<std::size_t>(m_indices[i]));
+                        return m_num_active == 0;
+                    }
+
+                    /** @brief wait for all active requests to complete */
+                    void wait_all()
+                    {
+                        if (m_num_active == 0) return;
+                        GHEX_CHECK_MPI_RESULT(MPI_Waitall(static_cast<int>(m_reqs.size()), m_reqs.data(),
+                            MPI_STATUSES_IGNORE));
+                        m_num_active = 0;
+                    }
+
+                    /** @brief test whether all active requests have completed
+                      * @return true if no request is active anymore */
+                    bool test_all()
+                    {
+                        if (m_num_active == 0) return true;
+                        int flag = 0;
+                        GHEX_CHECK_MPI_RESULT(MPI_Testall(static_cast<int>(m_reqs.size()), m_reqs.data(),
+                            &flag, MPI_STATUSES_IGNORE));
+                        if (flag) m_num_active = 0;
+                        return flag != 0;
+                    }
+
+                    /** @brief wait for outstanding requests and free all requests in this set */
+                    void free() noexcept
+                    {
+                        int finalized = 0;
+                        MPI_Finalized(&finalized);
+                        if (finalized)
+                        {
+                            // requests can not be freed anymore
+                            m_reqs.clear();
+                            m_num_active = 0;
+                        }
+                        if (m_num_active > 0)
+                            MPI_Waitall(static_cast<int>(m_reqs.size()), m_reqs.data(), MPI_STATUSES_IGNORE);
+                        for (auto& r : m_reqs)
+                            if (r != MPI_REQUEST_NULL) MPI_Request_free(&r);
+                        m_reqs.clear();
+                        m_indices.clear();
+                        m_num_active = 0;
+                    }
+                };
+
+            } // namespace mpi
+        } // namespace tl
+    } // namespace ghex
+} // namespace gridtools
+
+#endif /* INCLUDED_GHEX_TL_MPI_PERSISTENT_REQUEST_HPP */
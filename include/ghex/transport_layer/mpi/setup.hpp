@@ -15,6 +15,7 @@
 #include "./status.hpp"
 #include "./future.hpp"
 #include <vector>
+#include <map>
 #include <cassert>
 #include <algorithm>
 
@@ -181,7 +182,114 @@ namespace gridtools{
                              reinterpret_cast<void*>(recv_buf.data()), &recv_counts_b[0], &recv_displs_b[0], MPI_BYTE,
                              *this));
                 }
-            
+
+                /** @brief sparse dynamic data exchange: sends a payload to each rank in the map, where the receivers
+                  * do not know in advance from which ranks they receive. Implemented with the NBX algorithm
+                  * (synchronous non-blocking sends, probing for incoming messages and a non-blocking barrier
+                  * which is entered once all sends have been matched), which needs no collective operation
+                  * proportional to the number of ranks. Must be called by all ranks of the communicator. The
+                  * messages are exchanged on a duplicate of the communicator, such that they cannot be confused
+                  * with messages sent by ranks which have already left this function.
+                  * @tparam T payload value type
+                  * @param payloads map from destination rank to payload
+                  * @param tag message tag
+                  * @return map from source rank to received payload */
+                template<typename T>
+                std::map<int, std::vector<T>> sparse_exchange(const std::map<int, std::vector<T>>& payloads, int tag) const
+                {
+                    MPI_Comm comm;
+                    GHEX_CHECK_MPI_RESULT(MPI_Comm_dup(*this, &comm));
+                    std::vector<MPI_Request> send_reqs;
+                    send_reqs.reserve(payloads.size());
+                    for (const auto& p : payloads)
+                    {
+                        send_reqs.push_back(MPI_REQUEST_NULL);
+                        GHEX_CHECK_MPI_RESULT(MPI_Issend(reinterpret_cast<const void*>(p.second.data()),
+                            static_cast<int>(sizeof(T)*p.second.size()), MPI_BYTE, p.first, tag, comm, &send_reqs.back()));
+                    }
+                    std::map<int, std::vector<T>> res;
+                    MPI_Request barrier_req = MPI_REQUEST_NULL;
+                    bool barrier_active = false;
+                    while (true)
+                    {
+                        // receive any incoming message
+                        int flag;
+                        MPI_Status status;
+                        GHEX_CHECK_MPI_RESULT(MPI_Iprobe(MPI_ANY_SOURCE, tag, comm, &flag, &status));
+                        if (flag)
+                        {
+                            int count;
+                            GHEX_CHECK_MPI_RESULT(MPI_Get_count(&status, MPI_BYTE, &count));
+                            auto& vec = res[status.MPI_SOURCE];
+                            vec.resize(count/sizeof(T));
+                            GHEX_CHECK_MPI_RESULT(MPI_Recv(reinterpret_cast<void*>(vec.data()), count, MPI_BYTE,
+                                status.MPI_SOURCE, tag, comm, MPI_STATUS_IGNORE));
+                        }
+                        if (barrier_active)
+                        {
+                            // all ranks have completed their sends: no more messages are on the way
+                            GHEX_CHECK_MPI_RESULT(MPI_Test(&barrier_req, &flag, MPI_STATUS_IGNORE));
+                            if (flag) break;
+                        }
+                        else
+                        {
+                            // enter the barrier once all my messages have been received
+                            GHEX_CHECK_MPI_RESULT(MPI_Testall(static_cast<int>(send_reqs.size()), send_reqs.data(), &flag,
+                                MPI_STATUSES_IGNORE));
+                            if (flag)
+                            {
+                                GHEX_CHECK_MPI_RESULT(MPI_Ibarrier(comm, &barrier_req));
+                                barrier_active = true;
+                            }
+                        }
+                    }
+                    GHEX_CHECK_MPI_RESULT(MPI_Comm_free(&comm));
+                    return res;
+                }
+
+                /** @brief exchanges a value with each neighbor rank. The neighbor relation must be symmetric,
+                  * i.e. each rank must be listed by all of its neighbors. One message is sent to each distinct
+                  * neighbor rank, such that neighbors may be listed several times. Must be called by all ranks of
+                  * the communicator: the messages are exchanged on a duplicate of the communicator, such that they
+                  * cannot be confused with messages of the transport layer which are still in flight.
+                  * @tparam T value type
+                  * @param value value to be sent to all neighbors
+                  * @param neighbors neighbor ranks
+                  * @param tag message tag
+                  * @return values received from the neighbors (in the order of neighbors) */
+                template<typename T>
+                std::vector<T> neighbor_exchange(const T& value, const std::vector<int>& neighbors, int tag) const
+                {
+                    std::vector<int> ranks(neighbors);
+                    std::sort(ranks.begin(), ranks.end());
+                    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+                    MPI_Comm comm;
+                    GHEX_CHECK_MPI_RESULT(MPI_Comm_dup(*this, &comm));
+                    std::vector<T> values(ranks.size());
+                    std::vector<MPI_Request> reqs(ranks.size()*2, MPI_REQUEST_NULL);
+                    for (unsigned int i=0; i<ranks.size(); ++i)
+                        GHEX_CHECK_MPI_RESULT(MPI_Irecv(reinterpret_cast<void*>(&values[i]), sizeof(T), MPI_BYTE,
+                            ranks[i], tag, comm, &reqs[i]));
+                    for (unsigned int i=0; i<ranks.size(); ++i)
+                        GHEX_CHECK_MPI_RESULT(MPI_Isend(reinterpret_cast<const void*>(&value), sizeof(T), MPI_BYTE,
+                            ranks[i], tag, comm, &reqs[ranks.size()+i]));
+                    GHEX_CHECK_MPI_RESULT(MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE));
+                    GHEX_CHECK_MPI_RESULT(MPI_Comm_free(&comm));
+                    std::vector<T> res;
+                    res.reserve(neighbors.size());
+                    for (auto n : neighbors)
+                        res.push_back(values[std::lower_bound(ranks.begin(), ranks.end(), n) - ranks.begin()]);
+                    return res;
+                }
+
+                /** @brief computes the maximum of a value among all ranks (reduction) */
+                int all_max(int value) const
+                {
+                    int res;
+                    GHEX_CHECK_MPI_RESULT(MPI_Allreduce(&value, &res, 1, MPI_INT, MPI_MAX, *this));
+                    return res;
+                }
+
             };
 
             } // namespace mpi
@@ -101,6 +101,9 @@ public:
     
     /** returns domain coordinate given rank and thread index */
     array_type operator()(size_type rank, size_type thread_idx) const noexcept { return this->operator()(rank*threads_per_rank()+thread_idx); }
+
+    /** returns domain index given a domain coordinate */
+    size_type domain_index(const array_type& coord) const noexcept { return m_resource_layout.resource_index(coord); }
 };
 
 } //namespace ghex
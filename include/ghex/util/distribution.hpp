@@ -101,6 +101,20 @@ public:
             }
         return res;
     }
+
+    /** @brief Computes the scalar index of a coordinate within the hypercube (inverse of operator())
+      * @param coord Coordinates
+      * @return Scalar index (enumerator) */
+    size_type index(const array_type& coord) const noexcept
+    {
+        size_type idx = 0;
+        for (unsigned int i=0; i<N; ++i)
+        {
+            assert(coord[i] < m_dims[i]);
+            idx += coord[i]*m_partial_product[i];
+        }
+        return idx;
+    }
 };
 
 // alias definition used for a hierarchical, regular domain decomposition
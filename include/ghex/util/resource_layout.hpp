@@ -130,6 +130,24 @@ public:
         get_coord(indices, res, std::integral_constant<unsigned int, Levels-1>());
         return res;
     }
+
+    /** returns resource index given a spatial coordinate (inverse of operator()) */
+    size_type resource_index(const array_type& coord) const noexcept
+    {
+        typename distribution_type::array_type indices;
+        array_type c = coord;
+        for (unsigned int j=Levels; j>0; --j)
+        {
+            array_type level_coord;
+            for (unsigned i=0; i<D; ++i)
+            {
+                level_coord[i] = c[i] % m_dims[j-1].dims()[i];
+                c[i] /= m_dims[j-1].dims()[i];
+            }
+            indices[j-1] = m_dims[j-1].index(level_coord);
+        }
+        return m_dist.index(indices);
+    }
     
 private:
     size_type relative_resource(size_type idx, std::integral_constant<unsigned int, 0>) const noexcept
@@ -0,0 +1,87 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/box_index.hpp>
+#include <ghex/common/coordinate.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <random>
+#include <vector>
+
+using coordinate_type = gridtools::ghex::coordinate<std::array<int,3>>;
+using index_type = gridtools::ghex::structured::box_index<coordinate_type>;
+
+struct box
+{
+    coordinate_type m_first;
+    coordinate_type m_last;
+    const coordinate_type& first() const noexcept { return m_first; }
+    const coordinate_type& last() const noexcept { return m_last; }
+};
+
+bool overlap(const box& a, const box& b)
+{
+    for (int d=0; d<3; ++d)
+        if (a.first()[d] > b.last()[d] || b.first()[d] > a.last()[d]) return false;
+    return true;
+}
+
+box random_box(std::mt19937& gen, const coordinate_type& first, const coordinate_type& last, int max_size)
+{
+    box b;
+    for (int d=0; d<3; ++d)
+    {
+        std::uniform_int_distribution<int> pos(first[d], last[d]);
+        std::uniform_int_distribution<int> size(0, max_size-1);
+        b.m_first[d] = pos(gen);
+        b.m_last[d] = b.m_first[d] + size(gen);
+    }
+    return b;
+}
+
+TEST(box_index, query)
+{
+    // compare the candidates of random queries with a brute force search
+    std::mt19937 gen(42);
+    const coordinate_type first{-3,0,5};
+    const coordinate_type last{60,40,9};
+    std::vector<box> boxes;
+    for (int i=0; i<200; ++i) boxes.push_back(random_box(gen, first, last, 12));
+    const index_type index(first, last, boxes);
+
+    for (int q=0; q<500; ++q)
+    {
+        // queries may reach beyond the bounding box
+        const auto b = random_box(gen, first-4, last, 20);
+        std::vector<std::size_t> expected;
+        for (std::size_t i=0; i<boxes.size(); ++i)
+            if (overlap(b, boxes[i])) expected.push_back(i);
+        std::vector<std::size_t> result{1000};
+        index.query(b.first(), b.last(), result);
+        ASSERT_EQ(result.size(), expected.size()+1);
+        EXPECT_EQ(result[0], 1000u);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), result.begin()+1));
+    }
+}
+
+TEST(box_index, single_box)
+{
+    const coordinate_type first{0,0,0};
+    const coordinate_type last{9,9,9};
+    std::vector<box> boxes{box{first, last}};
+    const index_type index(first, last, boxes);
+    std::vector<std::size_t> result;
+    index.query(coordinate_type{3,3,3}, coordinate_type{12,4,4}, result);
+    ASSERT_EQ(result.size(), 1u);
+    result.clear();
+    index.query(coordinate_type{10,0,0}, coordinate_type{12,4,4}, result);
+    EXPECT_TRUE(result.empty());
+}
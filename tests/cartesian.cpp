@@ -0,0 +1,103 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/cartesian_decomposition.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include "../utils/structured_test_utils.hpp"
+
+using transport = gridtools::ghex::tl::mpi_tag;
+using factory = gridtools::ghex::tl::context_factory<transport>;
+using decomposition_type = gridtools::ghex::structured::regular::cartesian_decomposition<3>;
+using domain_descriptor_type = decomposition_type::domain_type;
+using halo_generator_type = gridtools::ghex::structured::regular::halo_generator<int,3>;
+
+// the analytically computed pattern must be identical to the pattern computed from the gathered domains
+template<typename Context>
+void check_pattern(Context& context, const decomposition_type& decomposition, const std::array<int,6>& halos,
+    const std::array<bool,3>& periodic,
+    const halo_generator_type::footprint_type& footprint = halo_generator_type::footprint_type::full())
+{
+    halo_generator_type hgen(decomposition.global_first(), decomposition.global_last(), halos, periodic, footprint);
+    auto pattern_a = gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen, decomposition);
+    std::vector<domain_descriptor_type> domains(decomposition.begin(), decomposition.end());
+    auto pattern_b = gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen, domains);
+
+    compare_patterns(pattern_a, pattern_b);
+}
+
+// non-uniform offsets: slab i has extent base+i
+decomposition_type::offsets_type make_offsets(const std::array<int,3>& dims, int base)
+{
+    decomposition_type::offsets_type offsets;
+    for (int d=0; d<3; ++d)
+    {
+        offsets[d].push_back(-d);
+        for (int i=0; i<dims[d]; ++i) offsets[d].push_back(offsets[d].back()+base+i);
+    }
+    return offsets;
+}
+
+TEST(cartesian, cart_comm)
+{
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    std::array<int,3> dims{0,0,0};
+    MPI_Dims_create(size, 3, dims.data());
+    std::array<int,3> periods{1,1,0};
+    MPI_Comm cart_comm;
+    MPI_Cart_create(MPI_COMM_WORLD, 3, dims.data(), periods.data(), 0, &cart_comm);
+    {
+        auto context_ptr = factory::create(cart_comm);
+        auto& context = *context_ptr;
+        const decomposition_type decomposition(context.mpi_comm(), make_offsets(dims, 3));
+        EXPECT_EQ(decomposition.size(), 1u);
+        check_pattern(context, decomposition, {1,1,1,1,1,1}, {true,true,false});
+        check_pattern(context, decomposition, {2,3,0,1,3,2}, {true,true,false});
+        check_pattern(context, decomposition, {2,3,0,1,3,2}, {true,true,false},
+            halo_generator_type::footprint_type::faces());
+        // halos wider than the domains
+        check_pattern(context, decomposition, {4,5,4,0,1,1}, {true,true,true});
+
+        // the same decomposition from the local extents
+        int coords[3];
+        MPI_Cart_coords(context.mpi_comm(), context.rank(), 3, coords);
+        const decomposition_type decomposition_b(context.mpi_comm(),
+            decomposition_type::coordinate_type{3+coords[0], 3+coords[1], 3+coords[2]});
+        const auto d_a = *decomposition.begin();
+        const auto d_b = *decomposition_b.begin();
+        EXPECT_EQ(d_a.domain_id(), d_b.domain_id());
+        for (int d=0; d<3; ++d)
+        {
+            EXPECT_EQ(d_a.first()[d], d_b.first()[d]-d);
+            EXPECT_EQ(d_a.last()[d], d_b.last()[d]-d);
+        }
+    }
+    MPI_Comm_free(&cart_comm);
+}
+
+TEST(cartesian, hierarchical_decomposition)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const int size = context.size();
+    // 2 domains per rank along the first dimension, ranks along the second dimension
+    gridtools::ghex::hierarchical_decomposition<3> h_decomposition({1,1,1}, {1,1,1}, {1,size,1}, {2,1,1});
+    const std::array<int,3> dims{2,size,1};
+    const decomposition_type decomposition(context.mpi_comm(), h_decomposition, make_offsets(dims, 4));
+    EXPECT_EQ(decomposition.size(), 2u);
+    check_pattern(context, decomposition, {1,1,1,1,0,0}, {true,true,true});
+    check_pattern(context, decomposition, {3,2,2,3,1,1}, {false,true,true});
+}
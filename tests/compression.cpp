@@ -0,0 +1,63 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/compression.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+template<typename T>
+std::vector<unsigned char> round_trip(const std::vector<T>& data)
+{
+    using namespace gridtools::ghex;
+    const compression::shuffle_lz_codec c(sizeof(T));
+    const auto size = data.size()*sizeof(T);
+    std::vector<unsigned char> msg;
+    compression::encode(c, reinterpret_cast<const unsigned char*>(data.data()), size, msg);
+    EXPECT_TRUE(msg.size() <= compression::max_message_size(size));
+    std::vector<T> res(data.size());
+    compression::decode(c, msg.data(), reinterpret_cast<unsigned char*>(res.data()), size);
+    EXPECT_TRUE(res == data);
+    return msg;
+}
+
+TEST(compression, smooth)
+{
+    std::vector<double> data(10000);
+    for (std::size_t i=0; i<data.size(); ++i) data[i] = std::sin(i*0.001);
+    const auto msg = round_trip(data);
+    EXPECT_TRUE(msg.size() < data.size()*sizeof(double));
+}
+
+TEST(compression, constant)
+{
+    std::vector<float> data(4099, 1.5f);
+    const auto msg = round_trip(data);
+    EXPECT_TRUE(msg.size() < 100u);
+}
+
+TEST(compression, random)
+{
+    // incompressible data is sent as is
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<unsigned char> data(3001);
+    for (auto& x : data) x = static_cast<unsigned char>(dist(gen));
+    const auto msg = round_trip(data);
+    EXPECT_TRUE(msg.size() == gridtools::ghex::compression::max_message_size(data.size()));
+}
+
+TEST(compression, small)
+{
+    for (std::size_t n=0; n<20; ++n)
+        round_trip(std::vector<unsigned char>(n, 7));
+}
@@ -68,6 +68,7 @@ void test_distribution_3(int X, int Y, int Z)
             EXPECT_EQ(dist_a(i)[0], x);
             EXPECT_EQ(dist_a(i)[1], y);
             EXPECT_EQ(dist_a(i)[2], z);
+            EXPECT_EQ(dist_a.index(dist_a(i)), i);
             ++i;
         }
 
@@ -80,6 +81,7 @@ void test_distribution_3(int X, int Y, int Z)
             EXPECT_EQ(dist_b(i)[0], x);
             EXPECT_EQ(dist_b(i)[1], y);
             EXPECT_EQ(dist_b(i)[2], z);
+            EXPECT_EQ(dist_b.index(dist_b(i)), i);
             ++i;
         }
 }
@@ -179,6 +181,9 @@ void test_decomposition_3_4(
                     EXPECT_EQ( decomp(idx)[1], thread_y + thread_Y*(rank_y + rank_Y*(numa_y + numa_Y*(node_y))));
                     EXPECT_EQ( decomp(idx)[2], thread_z + thread_Z*(rank_z + rank_Z*(numa_z + numa_Z*(node_z))));
 
+                    // check inverse
+                    EXPECT_EQ( decomp.domain_index(decomp(idx)), idx );
+
                     ++idx;
                     ++thread_idx;
                     ++node_res;
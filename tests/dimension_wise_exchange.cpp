@@ -0,0 +1,99 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/structured/dimension_wise_exchange.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <utility>
+#include <vector>
+#include "../utils/structured_test_utils.hpp"
+
+using namespace gridtools::ghex;
+using arr = std::array<int,3>;
+using halos_type = std::array<int,6>;
+using transport = tl::mpi_tag;
+using factory = tl::context_factory<transport>;
+using domain_descriptor_type = structured::regular::domain_descriptor<int,3>;
+using halo_generator_type = structured::regular::halo_generator<int,3>;
+using field_type = test_fields<3>::field_type;
+
+constexpr int extent = 4;
+const halos_type halos{2,1,1,2,1,1};
+
+// eight domains per rank (2x2x2)
+std::vector<domain_descriptor_type> make_domains(int rank)
+{
+    std::vector<domain_descriptor_type> domains;
+    for (int k=0; k<2; ++k)
+        for (int j=0; j<2; ++j)
+            for (int i=0; i<2; ++i)
+            {
+                const arr first{(rank*2+i)*extent, j*extent, k*extent};
+                domains.push_back(domain_descriptor_type{rank*8+k*4+j*2+i, first,
+                    arr{first[0]+extent-1, first[1]+extent-1, first[2]+extent-1}});
+            }
+    return domains;
+}
+
+template<typename CommunicationObject, std::size_t... Is>
+void exchange(CommunicationObject& co, std::vector<field_type>& f, std::index_sequence<Is...>)
+{
+    co.exchange(f[Is]...);
+}
+
+void check(const std::array<bool,3>& periodic)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const auto domains = make_domains(context.rank());
+    const arr g_last{context.size()*2*extent-1, 2*extent-1, 2*extent-1};
+    halo_generator_type hgen(arr{0,0,0}, g_last, halos, periodic);
+    const auto patterns = make_pattern<structured::grid>(context, hgen, domains);
+
+    auto co = structured::make_dimension_wise_communication_object(patterns, hgen, context.get_communicator());
+    ASSERT_EQ(co.phases().size(), 3u);
+    int phase_neighbors = 0;
+    for (const auto& phase : co.phases())
+    {
+        EXPECT_EQ(phase.max_tag(), patterns.max_tag());
+        // at most two face neighbors per dimension
+        for (const auto& p : phase)
+        {
+            EXPECT_LE(p.recv_halos().size(), 2u);
+            EXPECT_LE(p.send_halos().size(), 2u);
+        }
+        phase_neighbors += num_neighbors(phase);
+    }
+    EXPECT_LT(phase_neighbors, num_neighbors(patterns));
+
+    // corner and edge halos are filled through the face neighbors
+    test_fields<3> f(domains, g_last, halos, periodic);
+    exchange(co, f.descriptors, std::make_index_sequence<8>());
+    EXPECT_TRUE(f.check());
+    test_fields<3> g(domains, g_last, halos, periodic);
+    exchange(co, g.descriptors, std::make_index_sequence<8>());
+    EXPECT_TRUE(g.check());
+}
+
+TEST(dimension_wise_exchange, periodic)
+{
+    check({true,true,true});
+}
+
+TEST(dimension_wise_exchange, non_periodic)
+{
+    check({true,false,true});
+}
@@ -64,3 +64,23 @@ TEST(all_gather, all_gather_vector)
     EXPECT_TRUE(passed);
 }
 
+
+TEST(all_gather, sparse_exchange)
+{
+    using T = int;
+    gridtools::ghex::tl::mpi::communicator_base mpi_comm;
+    gridtools::ghex::tl::mpi::setup_communicator comm{mpi_comm};
+    const int rank = comm.address();
+    const int size = mpi_comm.size();
+
+    // send (dest+1) values to the next two ranks, nothing to rank 0
+    std::map<int, std::vector<T>> payloads;
+    for (int d : {(rank+1)%size, (rank+2)%size})
+        if (d != 0) payloads[d] = std::vector<T>(d+1, rank*100+d);
+    auto received = comm.sparse_exchange(payloads, 7);
+
+    std::map<int, std::vector<T>> expected;
+    for (int s : {(rank-1+size)%size, (rank-2+size)%size})
+        if (rank != 0) expected[s] = std::vector<T>(rank+1, s*100+rank);
+    EXPECT_TRUE(received == expected);
+}
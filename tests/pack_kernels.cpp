@@ -0,0 +1,169 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <ghex/structured/pack_kernels.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <array>
+#include <vector>
+
+using namespace gridtools::ghex::structured;
+
+// compare all available instruction sets against a reference copy
+void check_kernels(std::size_t row_bytes, std::size_t stride, std::size_t num_rows)
+{
+    std::vector<cpu_kernels::isa> levels{cpu_kernels::isa::scalar};
+    if (cpu_kernels::detect_isa() != cpu_kernels::isa::scalar) levels.push_back(cpu_kernels::isa::avx2);
+    if (cpu_kernels::detect_isa() == cpu_kernels::isa::avx512) levels.push_back(cpu_kernels::isa::avx512);
+
+    std::vector<unsigned char> field(stride*num_rows+row_bytes);
+    for (std::size_t i=0; i<field.size(); ++i) field[i] = static_cast<unsigned char>(i*7+3);
+    std::vector<unsigned char> reference(row_bytes*num_rows);
+    for (std::size_t r=0; r<num_rows; ++r)
+        for (std::size_t b=0; b<row_bytes; ++b)
+            reference[r*row_bytes+b] = field[r*stride+b];
+
+    for (auto level : levels)
+    {
+        std::vector<unsigned char> buffer(row_bytes*num_rows, 0);
+        cpu_kernels::gather(field.data(), stride, buffer.data(), row_bytes, num_rows, level);
+        EXPECT_TRUE(buffer == reference);
+
+        std::vector<unsigned char> result(field.size(), 0);
+        cpu_kernels::scatter(buffer.data(), result.data(), stride, row_bytes, num_rows, level);
+        for (std::size_t i=0; i<result.size(); ++i)
+        {
+            const bool in_row = (i%stride < row_bytes) && (i/stride < num_rows);
+            EXPECT_EQ(result[i], in_row ? field[i] : 0);
+        }
+    }
+}
+
+// iteration space pair with equal local and global coordinates (domain at the origin)
+struct test_iteration_space
+{
+    std::array<int,2> m_first;
+    std::array<int,2> m_last;
+    const std::array<int,2>& first() const noexcept { return m_first; }
+    const std::array<int,2>& last() const noexcept { return m_last; }
+    const test_iteration_space& local() const noexcept { return *this; }
+    const test_iteration_space& global() const noexcept { return *this; }
+    int size() const noexcept { return (m_last[0]-m_first[0]+1)*(m_last[1]-m_first[1]+1); }
+};
+
+TEST(pack_kernels, interleaved_components)
+{
+    // 4x3 domain with a halo of 1 and 3 components varying fastest
+    using domain_type = regular::domain_descriptor<int,2>;
+    using field_type  = regular::field_descriptor<int,gridtools::ghex::cpu,domain_type,1,0,2>;
+    const int nx = 6, ny = 5, nc = 3;
+    const domain_type dom{0, std::array<int,2>{0,0}, std::array<int,2>{3,2}};
+    std::vector<int> data(nx*ny*nc);
+    for (int y=0; y<ny; ++y)
+        for (int x=0; x<nx; ++x)
+            for (int c=0; c<nc; ++c)
+                data[(y*nx+x)*nc+c] = 100*y+10*x+c;
+    field_type field{dom, data.data(), std::array<int,3>{1,1,0}, std::array<int,3>{nx,ny,nc}, nc};
+    // the buffer holds the components of each point contiguously, followed by sentinels
+    const std::vector<test_iteration_space> c{test_iteration_space{{1,0},{2,2}}};
+    const int size = c[0].size()*nc;
+    std::vector<int> buffer(size+16, -1);
+    field.pack(buffer.data(), c, nullptr);
+    for (int y=0; y<3; ++y)
+        for (int x=0; x<2; ++x)
+            for (int k=0; k<nc; ++k)
+                EXPECT_EQ(buffer[(y*2+x)*nc+k], 100*(y+1)+10*(x+2)+k);
+    for (int i=size; i<(int)buffer.size(); ++i) EXPECT_EQ(buffer[i], -1);
+    // unpack into another field
+    std::vector<int> result(data.size(), -1);
+    field_type field_r{dom, result.data(), std::array<int,3>{1,1,0}, std::array<int,3>{nx,ny,nc}, nc};
+    field_r.unpack(buffer.data(), c, nullptr);
+    for (int y=0; y<ny; ++y)
+        for (int x=0; x<nx; ++x)
+            for (int k=0; k<nc; ++k)
+            {
+                const bool inside = (x>=2 && x<=3 && y>=1 && y<=3);
+                EXPECT_EQ(result[(y*nx+x)*nc+k], inside ? data[(y*nx+x)*nc+k] : -1);
+            }
+}
+
+TEST(pack_kernels, strided_rows)
+{
+    for (std::size_t row_bytes : {1, 4, 8, 12, 16, 20, 24})
+        for (std::size_t num_rows : {0, 1, 2, 7, 8, 15, 16, 17, 33})
+            for (std::size_t stride : {row_bytes, row_bytes+4, 3*row_bytes+8, std::size_t(4096)})
+                check_kernels(row_bytes, stride, num_rows);
+}
+
+TEST(pack_kernels, static_widths)
+{
+    // 3-wide x-halos (rows of 3 values) and 2-wide y-halos (blocks of 2 rows) of double precision fields
+    using value_type = double;
+    using row_widths = std::integer_sequence<int,3,3>;
+    using block_widths = std::integer_sequence<int,2,0>;
+    const std::size_t stride = 20*sizeof(value_type);
+    for (std::size_t row_elements : {1, 2, 3, 4, 5, 13})
+        for (std::size_t num_rows : {1, 2, 3, 4, 5, 19})
+        {
+            // kernel which is expected to be selected
+            auto expected = cpu_kernels::kernel::generic;
+            if (num_rows > 1 && row_elements == 3) expected = cpu_kernels::kernel::static_rows;
+            if (num_rows == 2) expected = (row_elements == 3) ?
+                cpu_kernels::kernel::static_tile : cpu_kernels::kernel::static_block;
+
+            std::vector<value_type> field(20*num_rows);
+            for (std::size_t i=0; i<field.size(); ++i) field[i] = i;
+            std::vector<value_type> buffer(row_elements*num_rows, -1);
+            EXPECT_EQ((cpu_kernels::gather_static<row_widths,block_widths>(field.data(), stride, buffer.data(),
+                row_elements, num_rows)), expected);
+            for (std::size_t r=0; r<num_rows; ++r)
+                for (std::size_t i=0; i<row_elements; ++i)
+                    EXPECT_EQ(buffer[r*row_elements+i], field[r*20+i]);
+            std::vector<value_type> result(field.size(), -1);
+            EXPECT_EQ((cpu_kernels::scatter_static<row_widths,block_widths>(buffer.data(), result.data(), stride,
+                row_elements, num_rows)), expected);
+            for (std::size_t i=0; i<result.size(); ++i)
+                EXPECT_EQ(result[i], (i%20 < row_elements) ? field[i] : -1);
+
+            // without static widths the generic kernels are used
+            EXPECT_EQ(cpu_kernels::gather_static(field.data(), stride, buffer.data(), row_elements, num_rows),
+                cpu_kernels::kernel::generic);
+            EXPECT_EQ(cpu_kernels::scatter_static(buffer.data(), result.data(), stride, row_elements, num_rows),
+                cpu_kernels::kernel::generic);
+        }
+}
+
+TEST(pack_kernels, streaming_stores)
+{
+    // rows are staged and written with non-temporal stores, or the source is prefetched while unpacking
+    using value_type = float;
+    const std::size_t num_cols = 1500;
+    const std::size_t stride = num_cols*sizeof(value_type);
+    std::vector<value_type> field(num_cols*600);
+    for (std::size_t i=0; i<field.size(); ++i) field[i] = i;
+    const gridtools::ghex::streaming_stores::scope s(0u);
+    for (std::size_t row_elements : {1, 3, 7, 600, 1500})
+        for (std::size_t num_rows : {1, 300, 600})
+        {
+            std::vector<value_type> buffer(row_elements*num_rows+1, -1);
+            // misaligned destination
+            cpu_kernels::gather_static(field.data(), stride, buffer.data()+1, row_elements, num_rows);
+            EXPECT_EQ(buffer[0], -1);
+            for (std::size_t r=0; r<num_rows; ++r)
+                for (std::size_t i=0; i<row_elements; ++i)
+                    EXPECT_EQ(buffer[1+r*row_elements+i], field[r*num_cols+i]);
+            std::vector<value_type> result(num_cols*num_rows, -1);
+            cpu_kernels::scatter_static(buffer.data()+1, result.data(), stride, row_elements, num_rows);
+            for (std::size_t i=0; i<result.size(); ++i)
+                EXPECT_EQ(result[i], (i%num_cols < row_elements) ? field[i] : -1);
+        }
+}
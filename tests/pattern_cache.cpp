@@ -0,0 +1,79 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern_cache.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../utils/structured_test_utils.hpp"
+
+using transport = gridtools::ghex::tl::mpi_tag;
+using factory = gridtools::ghex::tl::context_factory<transport>;
+using domain_descriptor_type = gridtools::ghex::structured::regular::domain_descriptor<int,3>;
+using halo_generator_type = gridtools::ghex::structured::regular::halo_generator<int,3>;
+
+TEST(pattern_cache, save_load)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const int rank = context.rank();
+    const int size = context.size();
+    const std::string prefix = "pattern_cache_test";
+    const std::string filename = prefix + "." + std::to_string(rank);
+    std::remove(filename.c_str());
+
+    // 2 domains per rank along the first dimension
+    std::vector<domain_descriptor_type> domains;
+    for (int i=0; i<2; ++i)
+        domains.push_back(domain_descriptor_type{rank*2+i,
+            std::array<int,3>{(rank*2+i)*6, 0, 0}, std::array<int,3>{(rank*2+i)*6+5, 7, 4}});
+    const std::array<int,3> g_first{0,0,0};
+    const std::array<int,3> g_last{size*12-1,7,4};
+    halo_generator_type hgen(g_first, g_last, std::array<int,6>{1,2,2,1,0,1}, std::array<bool,3>{true,true,false});
+    halo_generator_type hgen_b(g_first, g_last, std::array<int,6>{1,1,1,1,1,1}, std::array<bool,3>{true,true,false});
+
+    // keys depend on the halos and are equal on all ranks
+    const auto key = gridtools::ghex::structured::pattern_key(context, hgen, domains);
+    EXPECT_EQ(key, gridtools::ghex::structured::pattern_key(context, hgen, domains));
+    EXPECT_NE(key, gridtools::ghex::structured::pattern_key(context, hgen_b, domains));
+    auto keys = gridtools::ghex::tl::mpi::setup_communicator(context.mpi_comm()).all_gather(key).get();
+    for (auto k : keys) EXPECT_EQ(k, key);
+
+    const auto reference = gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen, domains);
+    using io_type = gridtools::ghex::detail::pattern_io<std::remove_const_t<decltype(reference)>::grid_type>;
+
+    // first call computes the patterns and writes the files
+    {
+        const auto patterns = gridtools::ghex::structured::make_cached_pattern(context, hgen, domains, prefix);
+        compare_patterns(patterns, reference);
+        const gridtools::ghex::detail::mapped_file f(filename);
+        EXPECT_TRUE(io_type::valid(f.data(), f.size(), key, rank, size));
+    }
+    // second call loads the patterns
+    {
+        const auto patterns = gridtools::ghex::structured::make_cached_pattern(context, hgen, domains, prefix);
+        compare_patterns(patterns, reference);
+    }
+    // different halos invalidate the files
+    {
+        const auto patterns = gridtools::ghex::structured::make_cached_pattern(context, hgen_b, domains, prefix);
+        compare_patterns(patterns,
+            gridtools::ghex::make_pattern<gridtools::ghex::structured::grid>(context, hgen_b, domains));
+        const gridtools::ghex::detail::mapped_file f(filename);
+        EXPECT_FALSE(io_type::valid(f.data(), f.size(), key, rank, size));
+    }
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,138 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern_coalesce.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/communication_object_2.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+
+using namespace gridtools::ghex;
+using arr = std::array<int,2>;
+using transport = tl::mpi_tag;
+using factory = tl::context_factory<transport>;
+using domain_descriptor_type = structured::regular::domain_descriptor<int,2>;
+using halo_generator_type = structured::regular::halo_generator<int,2>;
+
+constexpr int halo = 2;
+
+// number of iteration spaces of all halos
+template<typename PatternContainer>
+std::size_t num_spaces(const PatternContainer& pc)
+{
+    std::size_t n = 0;
+    for (const auto& p : pc)
+    {
+        for (const auto& h : p.recv_halos()) n += h.second.size();
+        for (const auto& h : p.send_halos()) n += h.second.size();
+    }
+    return n;
+}
+
+// the merged halos must cover the same number of elements for the same neighbors
+template<typename Map>
+void compare_elements(const Map& a, const Map& b)
+{
+    using index_container_type = typename Map::mapped_type;
+    using pattern_type = typename index_container_type::value_type::pattern_type;
+    ASSERT_EQ(a.size(), b.size());
+    auto it_b = b.begin();
+    for (const auto& p : a)
+    {
+        EXPECT_EQ(p.first.id, it_b->first.id);
+        EXPECT_EQ(p.first.tag, it_b->first.tag);
+        EXPECT_LE(p.second.size(), it_b->second.size());
+        EXPECT_EQ(pattern_type::num_elements(p.second), pattern_type::num_elements(it_b->second));
+        ++it_b;
+    }
+}
+
+// value of a point in global coordinates, or -1 if it is outside of the (non-periodic) global domain
+int value(int x, int y, const arr& g_last, const std::array<bool,2>& periodic)
+{
+    if (periodic[0]) x = (x + g_last[0]+1) % (g_last[0]+1);
+    if (periodic[1]) y = (y + g_last[1]+1) % (g_last[1]+1);
+    if (x < 0 || x > g_last[0] || y < 0 || y > g_last[1]) return -1;
+    return x*100 + y;
+}
+
+void check(const std::array<bool,2>& periodic)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const int rank = context.rank();
+    // per rank: one tall domain next to two short domains, such that the halos of the short domains
+    // towards the tall domain consist of several adjacent boxes
+    std::vector<domain_descriptor_type> domains{
+        domain_descriptor_type{rank*3,   arr{rank*16,   0}, arr{rank*16+7,  15}},
+        domain_descriptor_type{rank*3+1, arr{rank*16+8, 0}, arr{rank*16+15,  7}},
+        domain_descriptor_type{rank*3+2, arr{rank*16+8, 8}, arr{rank*16+15, 15}}};
+    const arr g_last{context.size()*16-1, 15};
+    halo_generator_type hgen(arr{0,0}, g_last, std::array<int,4>{halo,halo,halo,halo}, periodic);
+
+    const auto reference = make_pattern<structured::grid>(context, hgen, domains);
+    auto patterns = reference;
+    const auto removed = structured::coalesce_pattern(context, patterns);
+    EXPECT_GT(removed, 0u);
+    EXPECT_EQ(num_spaces(reference) - num_spaces(patterns), removed);
+    for (int i=0; i<patterns.size(); ++i)
+    {
+        compare_elements(patterns[i].recv_halos(), reference[i].recv_halos());
+        compare_elements(patterns[i].send_halos(), reference[i].send_halos());
+    }
+
+    // exchange with the merged patterns
+    std::vector<std::vector<int>> raw_fields;
+    for (const auto& d : domains)
+    {
+        const arr ext{d.last()[0]-d.first()[0]+1+2*halo, d.last()[1]-d.first()[1]+1+2*halo};
+        raw_fields.emplace_back(ext[0]*ext[1], -1);
+        auto& raw = raw_fields.back();
+        for (int j=halo; j<ext[1]-halo; ++j)
+            for (int i=halo; i<ext[0]-halo; ++i)
+                raw[j*ext[0]+i] = value(d.first()[0]+i-halo, d.first()[1]+j-halo, g_last, periodic);
+    }
+    auto wrap = [&](int k)
+    {
+        const auto& d = domains[k];
+        const arr ext{d.last()[0]-d.first()[0]+1+2*halo, d.last()[1]-d.first()[1]+1+2*halo};
+        return wrap_field<cpu,1,0>(d, raw_fields[k].data(), arr{halo,halo}, ext);
+    };
+    auto field_0 = wrap(0);
+    auto field_1 = wrap(1);
+    auto field_2 = wrap(2);
+    auto co = make_communication_object<std::remove_const_t<decltype(reference)>>(context.get_communicator());
+    co.exchange(patterns(field_0), patterns(field_1), patterns(field_2)).wait();
+
+    for (unsigned int k=0; k<domains.size(); ++k)
+    {
+        const auto& d = domains[k];
+        const arr ext{d.last()[0]-d.first()[0]+1+2*halo, d.last()[1]-d.first()[1]+1+2*halo};
+        for (int j=0; j<ext[1]; ++j)
+            for (int i=0; i<ext[0]; ++i)
+                EXPECT_EQ(raw_fields[k][j*ext[0]+i],
+                    value(d.first()[0]+i-halo, d.first()[1]+j-halo, g_last, periodic));
+    }
+}
+
+TEST(pattern_coalesce, periodic)
+{
+    check({true,true});
+}
+
+TEST(pattern_coalesce, non_periodic)
+{
+    check({true,false});
+}
@@ -0,0 +1,120 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/communication_object_2.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include "../utils/structured_test_utils.hpp"
+
+using namespace gridtools::ghex;
+using arr = std::array<int,3>;
+using halos_type = std::array<int,6>;
+using transport = tl::mpi_tag;
+using factory = tl::context_factory<transport>;
+using domain_descriptor_type = structured::regular::domain_descriptor<int,3>;
+using halo_generator_type = structured::regular::halo_generator<int,3>;
+
+// domain extents and halos of the full patterns
+const arr extents{6,5,4};
+const halos_type halos{2,2,2,2,1,1};
+const std::array<bool,3> periodic{false,true,false};
+
+// two domains per rank along the second dimension
+std::vector<domain_descriptor_type> make_domains(int rank)
+{
+    std::vector<domain_descriptor_type> domains;
+    for (int j=0; j<2; ++j)
+        domains.push_back(domain_descriptor_type{rank*2+j, arr{rank*extents[0], j*extents[1], 0},
+            arr{(rank+1)*extents[0]-1, (j+1)*extents[1]-1, extents[2]-1}});
+    return domains;
+}
+
+halo_generator_type make_halo_generator(int size, const halos_type& h)
+{
+    return {arr{0,0,0}, arr{size*extents[0]-1, 2*extents[1]-1, extents[2]-1}, h, periodic};
+}
+
+// the tags of the restricted halos are the tags of the full halos
+template<typename Map>
+void compare_tags(const Map& restricted, const Map& full)
+{
+    for (const auto& p : restricted)
+    {
+        auto it = full.find(p.first);
+        ASSERT_TRUE(it != full.end());
+        EXPECT_EQ(p.first.tag, it->first.tag);
+    }
+}
+
+TEST(pattern_restrict, narrower_halos)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const auto domains = make_domains(context.rank());
+    const auto patterns = make_pattern<structured::grid>(context, make_halo_generator(context.size(), halos),
+        domains);
+
+    for (const auto& h : {halos_type{1,1,1,1,1,1}, halos_type{1,2,0,1,0,0}, halos_type{0,0,2,0,1,0}, halos})
+    {
+        const auto restricted = patterns.restrict(h);
+        const auto reference = make_pattern<structured::grid>(context, make_halo_generator(context.size(), h),
+            domains);
+        EXPECT_EQ(restricted.max_tag(), patterns.max_tag());
+        ASSERT_EQ(restricted.size(), reference.size());
+        for (int i=0; i<restricted.size(); ++i)
+        {
+            compare_halos(restricted[i].recv_halos(), reference[i].recv_halos(), false);
+            compare_halos(restricted[i].send_halos(), reference[i].send_halos(), false);
+            compare_tags(restricted[i].recv_halos(), patterns[i].recv_halos());
+            compare_tags(restricted[i].send_halos(), patterns[i].send_halos());
+        }
+    }
+}
+
+TEST(pattern_restrict, exchange)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const auto domains = make_domains(context.rank());
+    const auto patterns = make_pattern<structured::grid>(context, make_halo_generator(context.size(), halos),
+        domains);
+    const halos_type h{1,0,1,1,1,1};
+    const std::array<int,2> k_range{1,2};
+    const auto restricted = patterns.restrict(h, k_range);
+
+    // exchange the full and the restricted halos in the same call
+    const arr g_last{context.size()*extents[0]-1, 2*extents[1]-1, extents[2]-1};
+    test_fields<3> f_full(domains, g_last, halos, periodic);
+    test_fields<3> f_restricted(domains, g_last, halos, periodic);
+    auto co = make_communication_object<std::remove_const_t<decltype(patterns)>>(context.get_communicator());
+    co.exchange(patterns(f_full(0)), patterns(f_full(1)), restricted(f_restricted(0)),
+        restricted(f_restricted(1))).wait();
+
+    for (int n=0; n<2; ++n)
+        for (int k=-halos[4]; k<extents[2]+halos[5]; ++k)
+            for (int j=-halos[2]; j<extents[1]+halos[3]; ++j)
+                for (int i=-halos[0]; i<extents[0]+halos[1]; ++i)
+                {
+                    EXPECT_EQ(f_full.at(n,i,j,k), f_full.value(n,i,j,k));
+                    const bool interior = i >= 0 && i < extents[0] && j >= 0 && j < extents[1] && k >= 0 &&
+                        k < extents[2];
+                    const bool restricted_halo = i >= -h[0] && i < extents[0]+h[1] && j >= -h[2] &&
+                        j < extents[1]+h[3] && k >= k_range[0] && k <= k_range[1];
+                    EXPECT_EQ(f_restricted.at(n,i,j,k),
+                        (interior || restricted_halo) ? f_restricted.value(n,i,j,k) : -1);
+                }
+}
@@ -0,0 +1,104 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/communication_object_2.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+#include "../utils/structured_test_utils.hpp"
+
+using namespace gridtools::ghex;
+using arr = std::array<int,2>;
+using transport = tl::mpi_tag;
+using factory = tl::context_factory<transport>;
+using domain_descriptor_type = structured::regular::domain_descriptor<int,2>;
+using halo_generator_type = structured::regular::halo_generator<int,2>;
+
+constexpr int halo = 2;
+constexpr int extent = 8;
+
+// domains in a row along the first dimension
+domain_descriptor_type make_domain(int id)
+{
+    return {id, arr{id*extent, 0}, arr{id*extent+extent-1, extent-1}};
+}
+
+// two fields holding the global coordinates in their interior
+test_fields<2> make_fields(const std::vector<domain_descriptor_type>& domains, int num_domains)
+{
+    return {domains, arr{num_domains*extent-1, extent-1}, {halo,halo,halo,halo}, {true,true}};
+}
+
+TEST(pattern_update, migrate)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const int rank = context.rank();
+    const int size = context.size();
+    const int num_domains = 2*size;
+    halo_generator_type hgen(arr{0,0}, arr{num_domains*extent-1, extent-1}, std::array<int,4>{halo,halo,halo,halo},
+        std::array<bool,2>{true,true});
+
+    // two neighboring domains per rank
+    std::vector<domain_descriptor_type> domains{make_domain(2*rank), make_domain(2*rank+1)};
+    auto patterns = make_pattern<structured::grid>(context, hgen, domains);
+    using pattern_container_type = decltype(patterns);
+    auto co = make_communication_object<pattern_container_type>(context.get_communicator());
+    auto f = make_fields(domains, num_domains);
+    co.exchange(patterns(f(0)), patterns(f(1))).wait();
+    EXPECT_TRUE(f.check());
+    auto f_plan = make_fields(domains, num_domains);
+    auto plan = co.make_exchange_plan(patterns(f_plan(0)), patterns(f_plan(1)));
+    plan.exchange().wait();
+    EXPECT_TRUE(f_plan.check());
+
+    // the second domain of each rank moves to the next rank
+    std::vector<pattern_container_type::migration_type> migrations;
+    for (int r=0; r<size; ++r) migrations.push_back({2*r+1, (r+1)%size});
+    patterns.update(context, migrations);
+
+    std::vector<domain_descriptor_type> new_domains{make_domain(2*rank), make_domain(2*((rank+size-1)%size)+1)};
+    // the updated tags need not equal the tags of a newly computed pattern
+    compare_patterns(patterns, make_pattern<structured::grid>(context, hgen, new_domains), false);
+
+    // exchange on the updated patterns
+    co.refresh();
+    auto g = make_fields(new_domains, num_domains);
+    co.exchange(patterns(g(0)), patterns(g(1))).wait();
+    EXPECT_TRUE(g.check());
+    auto g_plan = make_fields(new_domains, num_domains);
+    plan.refresh(patterns(g_plan(0)), patterns(g_plan(1)));
+    plan.exchange().wait();
+    EXPECT_TRUE(g_plan.check());
+}
+
+TEST(pattern_update, no_migration)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const int rank = context.rank();
+    const int num_domains = 2*context.size();
+    halo_generator_type hgen(arr{0,0}, arr{num_domains*extent-1, extent-1}, std::array<int,4>{halo,halo,halo,halo},
+        std::array<bool,2>{true,false});
+    std::vector<domain_descriptor_type> domains{make_domain(2*rank), make_domain(2*rank+1)};
+    const auto reference = make_pattern<structured::grid>(context, hgen, domains);
+    auto patterns = reference;
+    // domains which stay with their owners are not migrated
+    std::vector<decltype(patterns)::migration_type> migrations;
+    for (int r=0; r<context.size(); ++r) migrations.push_back({2*r, r});
+    patterns.update(context, migrations);
+    compare_patterns(patterns, reference);
+}
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <vector>
 #include <future>
+#include <set>
 
 #ifndef GHEX_TEST_USE_UCX
 #include <ghex/transport_layer/mpi/context.hpp>
@@ -13,10 +14,12 @@
 #include <ghex/transport_layer/util/barrier.hpp>
 #include <ghex/bulk_communication_object.hpp>
 #include <ghex/structured/pattern.hpp>
+#include <ghex/structured/communication_object_ipr.hpp>
 #include <ghex/structured/rma_range_generator.hpp>
 #include <ghex/structured/regular/domain_descriptor.hpp>
 #include <ghex/structured/regular/field_descriptor.hpp>
 #include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/structured/wire_field.hpp>
 #include <ghex/cuda_utils/error.hpp>
 #include <gridtools/common/array.hpp>
 
@@ -26,6 +29,7 @@ using transport = TRANSPORT;
 using factory   = tl::context_factory<transport>;
 using domain    = structured::regular::domain_descriptor<int,2>;
 using halo_gen  = structured::regular::halo_generator<int,2>;
+using static_halo_gen = structured::regular::halo_generator<int,2,structured::static_halos<3,3,3,3>>;
 
 #define DIM 8
 #define HALO 3
@@ -172,6 +176,56 @@ bool check(const Field& field, const arr& dims)
     return res;
 }
 
+// checks the interior in x-direction and the halos in y-direction only
+template<typename Field>
+bool check_y(const Field& field, const arr& dims)
+{
+    bool res = true;
+    for (int j=-HALO; j<DIM/2+HALO; ++j)
+    {
+        const auto y = expected(j, dims[1], field.domain().first()[1],
+            field.domain().last()[1], periodic[1]);
+        for (int i=0; i<DIM; ++i)
+            res = res && compare(field({i,j}), field.domain().first()[0]+i, y);
+    }
+    return res;
+}
+
+// field which counts the invocations of its fused pack and unpack functions
+template<typename Field>
+struct counting_field : public Field
+{
+    static int num_fused_packs;
+    static int num_fused_unpacks;
+    static std::size_t num_fused_fields; // fields per traversal of the last invocation
+    static bool streamed;                // last pack used non-temporal stores
+
+    counting_field(const Field& f) : Field(f) {}
+
+    template<typename IndexContainer, typename Fields, typename Buffers>
+    static void pack_fused(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c) {
+        ++num_fused_packs;
+        num_fused_fields = n;
+        streamed = streaming_stores::active();
+        Field::pack_fused(n, std::forward<Fields>(fields), std::forward<Buffers>(buffers), c);
+    }
+
+    template<typename IndexContainer, typename Fields, typename Buffers>
+    static void unpack_fused(std::size_t n, Fields&& fields, Buffers&& buffers, const IndexContainer& c) {
+        ++num_fused_unpacks;
+        num_fused_fields = n;
+        Field::unpack_fused(n, std::forward<Fields>(fields), std::forward<Buffers>(buffers), c);
+    }
+};
+template<typename Field>
+int counting_field<Field>::num_fused_packs = 0;
+template<typename Field>
+int counting_field<Field>::num_fused_unpacks = 0;
+template<typename Field>
+std::size_t counting_field<Field>::num_fused_fields = 0;
+template<typename Field>
+bool counting_field<Field>::streamed = false;
+
 auto make_domain(int rank, int id, std::array<int,2> coord)
 {
     const auto x = coord[0]*DIM;
@@ -287,6 +341,218 @@ bool run(Context& context, const Pattern& pattern, const Domains& domains, const
     raw_field_b.clone_to_device();
 #endif
 
+    // planned exchange (with and without persistent requests)
+    // ========================================================
+    for (int i=0; i<4; ++i)
+    {
+        co.use_persistent_requests(i<2);
+#ifdef __CUDACC__
+        auto plan = co.make_exchange_plan(pattern(field_a), pattern(field_b_gpu));
+#else
+        auto plan = co.make_exchange_plan(pattern(field_a), pattern(field_b));
+#endif
+        plan.exchange().wait();
+        plan.exchange().wait();
+
+        // check fields
+#ifdef __CUDACC__
+        raw_field_b.clone_to_host();
+#endif
+        res = res && check(field_a, dims);
+        res = res && check(field_b, dims);
+
+        // reset fields
+        reset(field_a);
+        reset(field_b);
+#ifdef __CUDACC__
+        raw_field_b.clone_to_device();
+#endif
+    }
+
+#ifndef __CUDACC__
+    // exchange through MPI datatypes (second exchange uses cached datatypes)
+    // ======================================================================
+    co.use_mpi_datatypes(true);
+    for (int i=0; i<3; ++i)
+    {
+        if (i<2)
+            co.exchange(pattern(field_a), pattern(field_b)).wait();
+        else
+            co.make_exchange_plan(pattern(field_a), pattern(field_b)).exchange().wait();
+        res = res && check(field_a, dims);
+        res = res && check(field_b, dims);
+        reset(field_a);
+        reset(field_b);
+    }
+    co.use_mpi_datatypes(false);
+#endif
+
+    // exchange with parallel packing (second exchange through a plan)
+    // ================================================================
+    co.use_parallel_packing(true, 2);
+    for (int i=0; i<2; ++i)
+    {
+#ifdef __CUDACC__
+        if (i==0)
+            co.exchange(pattern(field_a), pattern(field_b_gpu)).wait();
+        else
+            co.make_exchange_plan(pattern(field_a), pattern(field_b_gpu)).exchange().wait();
+        raw_field_b.clone_to_host();
+#else
+        if (i==0)
+            co.exchange(pattern(field_a), pattern(field_b)).wait();
+        else
+            co.make_exchange_plan(pattern(field_a), pattern(field_b)).exchange().wait();
+#endif
+        res = res && check(field_a, dims);
+        res = res && check(field_b, dims);
+        reset(field_a);
+        reset(field_b);
+#ifdef __CUDACC__
+        raw_field_b.clone_to_device();
+#endif
+    }
+    co.use_parallel_packing(false);
+
+    // compressed messages (i=0: exchange, i=1: plan, i=2: parallel packing)
+    // =====================================================================
+    co.use_compression(true, 0);
+    for (int i=0; i<3; ++i)
+    {
+        co.use_parallel_packing(i==2, 2);
+#ifdef __CUDACC__
+        if (i==1)
+            co.make_exchange_plan(pattern(field_a), pattern(field_b_gpu)).exchange().wait();
+        else
+            co.exchange(pattern(field_a), pattern(field_b_gpu)).wait();
+        raw_field_b.clone_to_host();
+#else
+        if (i==1)
+            co.make_exchange_plan(pattern(field_a), pattern(field_b)).exchange().wait();
+        else
+            co.exchange(pattern(field_a), pattern(field_b)).wait();
+#endif
+        res = res && check(field_a, dims);
+        res = res && check(field_b, dims);
+        reset(field_a);
+        reset(field_b);
+#ifdef __CUDACC__
+        raw_field_b.clone_to_device();
+#endif
+    }
+    {
+        const auto stats = co.get_compression_statistics();
+        res = res && (stats.message_bytes <= stats.raw_bytes + 64*sizeof(std::uint64_t));
+    }
+    co.use_parallel_packing(false);
+    co.use_compression(false);
+
+    // non-blocking completion and per-neighbor callbacks
+    // ==================================================
+    std::set<std::pair<int,int>> expected_neighbors;
+    for (const auto& p : pattern)
+        for (const auto& h : p.recv_halos())
+            expected_neighbors.insert(std::make_pair(p.domain_id(), h.first.id));
+    std::set<std::pair<int,int>> completed_neighbors;
+    co.set_neighbor_callback([&completed_neighbors](int local_id, int remote_id)
+        { completed_neighbors.insert(std::make_pair(local_id, remote_id)); });
+    for (int i=0; i<3; ++i)
+    {
+        // i=0: regular exchange, i=1: planned exchange, i=2: parallel packing
+        co.use_parallel_packing(i==2, 2);
+        completed_neighbors.clear();
+#ifdef __CUDACC__
+        auto plan = co.make_exchange_plan(pattern(field_a), pattern(field_b_gpu));
+        auto h = (i==1) ? plan.exchange() : co.exchange(pattern(field_a), pattern(field_b_gpu));
+        while (!h.test()) {}
+        raw_field_b.clone_to_host();
+#else
+        auto plan = co.make_exchange_plan(pattern(field_a), pattern(field_b));
+        auto h = (i==1) ? plan.exchange() : co.exchange(pattern(field_a), pattern(field_b));
+        if (i==2)
+            h.wait();
+        else
+            while (!h.ready()) {}
+#endif
+        res = res && h.test();
+        res = res && (completed_neighbors == expected_neighbors);
+        res = res && check(field_a, dims);
+        res = res && check(field_b, dims);
+        reset(field_a);
+        reset(field_b);
+#ifdef __CUDACC__
+        raw_field_b.clone_to_device();
+#endif
+    }
+    co.use_parallel_packing(false);
+    co.set_neighbor_callback({});
+
+    // exchange with in-place receive (halos are not contiguous: buffered fallback)
+    // ============================================================================
+    auto co_ipr = make_communication_object_ipr<Pattern>(comm);
+#ifdef __CUDACC__
+    co_ipr.exchange(pattern(field_a), pattern(field_b_gpu)).wait();
+    raw_field_b.clone_to_host();
+#else
+    co_ipr.exchange(pattern(field_a), pattern(field_b)).wait();
+#endif
+    res = res && check(field_a, dims);
+    res = res && check(field_b, dims);
+    reset(field_a);
+    reset(field_b);
+#ifdef __CUDACC__
+    raw_field_b.clone_to_device();
+#endif
+
+#ifndef __CUDACC__
+    // concurrent exchanges (two epochs, completed in reverse order)
+    // ==============================================================
+    {
+        auto raw_field_c = allocate_field();
+        auto raw_field_d = allocate_field();
+        auto field_c     = fill(wrap_cpu_field(raw_field_c, domains[0]));
+        auto field_d     = fill(wrap_cpu_field(raw_field_d, domains[1]));
+        auto co_epochs = make_communication_object<Pattern>(comm, 2);
+        res = res && (co_epochs.num_epochs() == 2);
+        for (int i=0; i<2; ++i)
+        {
+            auto h0 = co_epochs.exchange(pattern(field_a), pattern(field_b));
+            auto h1 = co_epochs.exchange(pattern(field_c), pattern(field_d));
+            // all epochs are busy
+            bool thrown = false;
+            try { co_epochs.exchange(pattern(field_a), pattern(field_b)).wait(); }
+            catch (std::runtime_error&) { thrown = true; }
+            res = res && thrown;
+            h1.wait();
+            h0.wait();
+            res = res && check(field_a, dims);
+            res = res && check(field_b, dims);
+            res = res && check(field_c, dims);
+            res = res && check(field_d, dims);
+            reset(field_a);
+            reset(field_b);
+            reset(field_c);
+            reset(field_d);
+        }
+    }
+
+    // several fields per domain (packed in one traversal)
+    // ===================================================
+    {
+        auto raw_field_c = allocate_field();
+        auto raw_field_d = allocate_field();
+        auto field_c     = fill(wrap_cpu_field(raw_field_c, domains[0]));
+        auto field_d     = fill(wrap_cpu_field(raw_field_d, domains[1]));
+        co.exchange(pattern(field_a), pattern(field_c), pattern(field_b), pattern(field_d)).wait();
+        res = res && check(field_a, dims);
+        res = res && check(field_b, dims);
+        res = res && check(field_c, dims);
+        res = res && check(field_d, dims);
+        reset(field_a);
+        reset(field_b);
+    }
+#endif
+
     barrier(comm);
 
     // bulk exchange (rma)
@@ -365,3 +631,352 @@ TEST(simple_regular_exchange, multi)
     sim(true);
 }
 
+TEST(simple_regular_exchange, fused_plan)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context    = *context_ptr;
+    // 2D domain decomposition
+    arr dims{0,0}, coords{0,0};
+    MPI_Dims_create(context.size(), 2, dims.data());
+    coords[1] = context.rank()/dims[0];
+    coords[0] = context.rank() - coords[1]*dims[0];
+    // make 2 domains per rank
+    std::vector<domain> domains{
+        make_domain(context.rank(), 0, coords),
+        make_domain(context.rank(), 1, coords)};
+    halo_gen gen{arr{0,0}, arr{dims[0]*DIM-1,dims[1]*DIM-1}, halos, periodic};
+    auto pattern = make_pattern<structured::grid>(context, gen, domains);
+    // 3 fields of the same type per domain
+    using field_type = counting_field<decltype(wrap_cpu_field(std::declval<memory<gridtools::array<int,2>>&>(),
+        domains[0]))>;
+    std::vector<memory<gridtools::array<int,2>>> raw_fields;
+    std::vector<field_type> fields;
+    for (int k=0; k<6; ++k) raw_fields.push_back(allocate_field());
+    for (int k=0; k<6; ++k) fields.push_back(fill(field_type{wrap_cpu_field(raw_fields[k], domains[k%2])}));
+    // planned exchange with persistent requests (the default)
+    auto co = make_communication_object<decltype(pattern)>(context.get_communicator());
+    auto plan = co.make_exchange_plan(pattern(fields[0]), pattern(fields[1]), pattern(fields[2]),
+        pattern(fields[3]), pattern(fields[4]), pattern(fields[5]));
+    plan.exchange().wait();
+    plan.exchange().wait();
+    bool res = true;
+    for (const auto& f : fields) res = res && check(f, dims);
+    // messages to other ranks are packed and unpacked in one traversal for all fields of a domain
+    if (context.size() > 1)
+    {
+        EXPECT_GT(field_type::num_fused_packs, 0);
+        EXPECT_GT(field_type::num_fused_unpacks, 0);
+        EXPECT_EQ(field_type::num_fused_fields, 3u);
+        EXPECT_FALSE(field_type::streamed);
+    }
+    // buffers above the threshold are packed with non-temporal stores
+    for (auto& f : fields) reset(f);
+    const auto threshold = streaming_stores::threshold();
+    streaming_stores::threshold() = 0u;
+    plan.exchange().wait();
+    streaming_stores::threshold() = threshold;
+    for (const auto& f : fields) res = res && check(f, dims);
+    if (context.size() > 1)
+    {
+        EXPECT_TRUE(field_type::streamed);
+    }
+    // reduce res
+    bool all_res = false;
+    MPI_Reduce(&res, &all_res, 1, MPI_C_BOOL, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (context.rank() == 0)
+    {
+        EXPECT_TRUE(all_res);
+    }
+}
+
+TEST(simple_regular_exchange, static_halos)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context    = *context_ptr;
+    // 2D domain decomposition
+    arr dims{0,0}, coords{0,0};
+    MPI_Dims_create(context.size(), 2, dims.data());
+    coords[1] = context.rank()/dims[0];
+    coords[0] = context.rank() - coords[1]*dims[0];
+    // make 2 domains per rank
+    std::vector<domain> domains{
+        make_domain(context.rank(), 0, coords),
+        make_domain(context.rank(), 1, coords)};
+    // halo widths are compile-time constants of the halo generator and of the fields
+    using static_halos_type = static_halo_gen::static_halos_type;
+    static_halo_gen gen{arr{0,0}, arr{dims[0]*DIM-1,dims[1]*DIM-1}, periodic};
+    auto pattern = make_pattern<structured::grid>(context, gen, domains);
+    auto raw_field_a = allocate_field();
+    auto raw_field_b = allocate_field();
+    auto field_a = fill(wrap_field<cpu,1,0>(domains[0], raw_field_a.data(), arr{HALO, HALO},
+        arr{HALO*2+DIM, HALO*2+DIM/2}, static_halos_type{}));
+    auto field_b = fill(wrap_field<cpu,1,0>(domains[1], raw_field_b.data(), arr{HALO, HALO},
+        arr{HALO*2+DIM, HALO*2+DIM/2}, static_halos_type{}));
+    static_assert(std::is_same<decltype(field_a)::static_halos_type, static_halos_type>::value,
+        "field does not carry the static halos");
+    // the patterns carry the static halos and reject fields with runtime halos
+    static_assert(std::is_same<decltype(pattern)::static_halos_type, static_halos_type>::value,
+        "pattern does not carry the static halos");
+    static_assert(!structured::detail::has_static_halos<decltype(wrap_cpu_field(raw_field_a, domains[0])),
+        static_halos_type>::value, "fields with runtime halos must not be bound to the pattern");
+    // exchange
+    auto co = make_communication_object<decltype(pattern)>(context.get_communicator());
+    co.exchange(pattern(field_a), pattern(field_b)).wait();
+    bool res = true;
+    res = res && check(field_a, dims);
+    res = res && check(field_b, dims);
+    // reduce res
+    bool all_res = false;
+    MPI_Reduce(&res, &all_res, 1, MPI_C_BOOL, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (context.rank() == 0)
+    {
+        EXPECT_TRUE(all_res);
+    }
+}
+
+
+TEST(simple_regular_exchange, zero_copy)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context    = *context_ptr;
+    // 2D domain decomposition
+    arr dims{0,0}, coords{0,0};
+    MPI_Dims_create(context.size(), 2, dims.data());
+    coords[1] = context.rank()/dims[0];
+    coords[0] = context.rank() - coords[1]*dims[0];
+    // make 2 domains per rank
+    std::vector<domain> domains{
+        make_domain(context.rank(), 0, coords),
+        make_domain(context.rank(), 1, coords)};
+    // halos in y-direction only: halo regions are contiguous in memory
+    const std::array<int,4> y_halos{0,0,HALO,HALO};
+    halo_gen gen{arr{0,0}, arr{dims[0]*DIM-1,dims[1]*DIM-1}, y_halos, periodic};
+    auto pattern = make_pattern<structured::grid>(context, gen, domains);
+    // fields without halo in x-direction
+    using value_type = gridtools::array<int,2>;
+    std::vector<value_type> raw_a(DIM*(DIM/2+2*HALO), value_type{-1,-1});
+    std::vector<value_type> raw_b(DIM*(DIM/2+2*HALO), value_type{-1,-1});
+    auto field_a = fill(wrap_field<cpu,1,0>(domains[0], raw_a.data(), arr{0, HALO}, arr{DIM, DIM/2+2*HALO}));
+    auto field_b = fill(wrap_field<cpu,1,0>(domains[1], raw_b.data(), arr{0, HALO}, arr{DIM, DIM/2+2*HALO}));
+    bool res = true;
+    for (const auto& p : pattern[0].recv_halos())
+        for (const auto& is : p.second)
+            res = res && (field_a.contiguous_ptr(is) != nullptr);
+    // exchange
+    auto co = make_communication_object<decltype(pattern)>(context.get_communicator());
+    co.exchange(pattern(field_a), pattern(field_b)).wait();
+    // check fields
+    res = res && check_y(field_a, dims);
+    res = res && check_y(field_b, dims);
+    // in-place receive: every field is received directly into its own halo
+    std::vector<value_type> raw_c(DIM*(DIM/2+2*HALO), value_type{-1,-1});
+    std::vector<value_type> raw_d(DIM*(DIM/2+2*HALO), value_type{-1,-1});
+    auto field_c = fill(wrap_field<cpu,1,0>(domains[0], raw_c.data(), arr{0, HALO}, arr{DIM, DIM/2+2*HALO}));
+    auto field_d = fill(wrap_field<cpu,1,0>(domains[1], raw_d.data(), arr{0, HALO}, arr{DIM, DIM/2+2*HALO}));
+    for (auto& v : raw_a) v = value_type{-1,-1};
+    for (auto& v : raw_b) v = value_type{-1,-1};
+    fill(field_a);
+    fill(field_b);
+    auto co_ipr = make_communication_object_ipr<decltype(pattern)>(context.get_communicator());
+    co_ipr.exchange(pattern(field_a), pattern(field_b), pattern(field_c), pattern(field_d)).wait();
+    res = res && check_y(field_a, dims);
+    res = res && check_y(field_b, dims);
+    res = res && check_y(field_c, dims);
+    res = res && check_y(field_d, dims);
+    // reduce res
+    bool all_res = false;
+    MPI_Reduce(&res, &all_res, 1, MPI_C_BOOL, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (context.rank() == 0)
+    {
+        EXPECT_TRUE(all_res);
+    }
+}
+
+TEST(simple_regular_exchange, local_copies)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context    = *context_ptr;
+    // 1D domain decomposition in x-direction
+    const arr dims{context.size(),1};
+    const arr coords{context.rank(),0};
+    // make 2 domains per rank which cover the whole extent in y-direction
+    std::vector<domain> domains{
+        make_domain(context.rank(), 0, coords),
+        make_domain(context.rank(), 1, coords)};
+    // periodic halos in y-direction only: all neighbors reside on the same rank
+    const std::array<int,4> y_halos{0,0,HALO,HALO};
+    halo_gen gen{arr{0,0}, arr{dims[0]*DIM-1,dims[1]*DIM-1}, y_halos, periodic};
+    auto pattern = make_pattern<structured::grid>(context, gen, domains);
+    auto co = make_communication_object<decltype(pattern)>(context.get_communicator());
+    bool res = true;
+    // fields of the same type: the halos are copied field to field, nothing is sent
+    auto raw_field_a = allocate_field();
+    auto raw_field_b = allocate_field();
+    auto field_a = fill(wrap_cpu_field(raw_field_a, domains[0]));
+    auto field_b = fill(wrap_cpu_field(raw_field_b, domains[1]));
+    co.exchange(pattern(field_a), pattern(field_b)).wait();
+    EXPECT_EQ(co.num_local_copies(), 2u);
+    EXPECT_EQ(co.num_send_buffers(), 0u);
+    res = res && check_y(field_a, dims);
+    res = res && check_y(field_b, dims);
+    // fields of different types: no local copies, the halos are sent through the transport layer
+    auto raw_field_c = allocate_field();
+    auto raw_field_d = allocate_field();
+    auto field_c = fill(wrap_field<cpu,1,0>(domains[0], raw_field_c.data(), arr{HALO, HALO},
+        arr{HALO*2+DIM, HALO*2+DIM/2}, structured::static_halos<0,0,HALO,HALO>{}));
+    auto field_d = fill(wrap_cpu_field(raw_field_d, domains[1]));
+    co.exchange(pattern(field_c), pattern(field_d)).wait();
+    EXPECT_EQ(co.num_local_copies(), 0u);
+    EXPECT_EQ(co.num_send_buffers(), 2u);
+    res = res && check_y(field_c, dims);
+    res = res && check_y(field_d, dims);
+    // reduce res
+    bool all_res = false;
+    MPI_Reduce(&res, &all_res, 1, MPI_C_BOOL, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (context.rank() == 0)
+    {
+        EXPECT_TRUE(all_res);
+    }
+}
+
+TEST(simple_regular_exchange, wire_type)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context    = *context_ptr;
+    // 2D domain decomposition
+    arr dims{0,0}, coords{0,0};
+    MPI_Dims_create(context.size(), 2, dims.data());
+    coords[1] = context.rank()/dims[0];
+    coords[0] = context.rank() - coords[1]*dims[0];
+    // make 2 domains per rank
+    std::vector<domain> domains{
+        make_domain(context.rank(), 0, coords),
+        make_domain(context.rank(), 1, coords)};
+    halo_gen gen{arr{0,0}, arr{dims[0]*DIM-1,dims[1]*DIM-1}, halos, periodic};
+    auto pattern = make_pattern<structured::grid>(context, gen, domains);
+    // scalar double precision fields, values are exactly representable in the wire types
+    const int ext_x = HALO*2+DIM;
+    const int ext_y = HALO*2+DIM/2;
+    auto encode_xy = [](int x, int y) { return (x == -1 || y == -1) ? -1.0 : x*1000.0+y; };
+    auto encode_x  = [](int x, int y) { return (x == -1 || y == -1) ? -1.0 : 1.0*x; };
+    auto make_raw  = [&]() { return std::vector<double>(ext_x*ext_y, -1.0); };
+    auto wrap      = [&](std::vector<double>& raw, const domain& d) {
+        return wrap_field<cpu,1,0>(d, raw.data(), arr{HALO, HALO}, arr{ext_x, ext_y}); };
+    auto fill_ = [](auto& field, auto encode) {
+        for (int j=0; j<DIM/2; ++j)
+            for (int i=0; i<DIM; ++i)
+                field({i,j}) = encode(field.domain().first()[0]+i, field.domain().first()[1]+j);
+    };
+    auto check_ = [&dims](const auto& field, auto encode) {
+        bool r = true;
+        for (int j=-HALO; j<DIM/2+HALO; ++j)
+        {
+            const auto y = expected(j, dims[1], field.domain().first()[1], field.domain().last()[1], periodic[1]);
+            for (int i=-HALO; i<DIM+HALO; ++i)
+            {
+                const auto x = expected(i, dims[0], field.domain().first()[0], field.domain().last()[0], periodic[0]);
+                r = r && (field({i,j}) == encode(x,y));
+            }
+        }
+        return r;
+    };
+    auto raw_a = make_raw();
+    auto raw_b = make_raw();
+    auto raw_c = make_raw();
+    auto raw_d = make_raw();
+    auto field_a = wrap(raw_a, domains[0]);
+    auto field_b = wrap(raw_b, domains[1]);
+    auto field_c = wrap(raw_c, domains[0]);
+    auto field_d = wrap(raw_d, domains[1]);
+    fill_(field_a, encode_xy);
+    fill_(field_b, encode_xy);
+    fill_(field_c, encode_x);
+    fill_(field_d, encode_x);
+    // float and bfloat16 on the wire
+    auto wire_a = structured::make_wire_field<float>(field_a);
+    auto wire_b = structured::make_wire_field<float>(field_b);
+    auto wire_c = structured::make_wire_field<bfloat16>(field_c);
+    auto wire_d = structured::make_wire_field<bfloat16>(field_d);
+    auto co = make_communication_object<decltype(pattern)>(context.get_communicator());
+    co.exchange(pattern(wire_a), pattern(wire_b), pattern(wire_c), pattern(wire_d)).wait();
+    bool res = true;
+    res = res && check_(field_a, encode_xy);
+    res = res && check_(field_b, encode_xy);
+    res = res && check_(field_c, encode_x);
+    res = res && check_(field_d, encode_x);
+    // reduce res
+    bool all_res = false;
+    MPI_Reduce(&res, &all_res, 1, MPI_C_BOOL, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (context.rank() == 0)
+    {
+        EXPECT_TRUE(all_res);
+    }
+}
+
+TEST(simple_regular_exchange, wire_layout)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context    = *context_ptr;
+    // 2D domain decomposition
+    arr dims{0,0}, coords{0,0};
+    MPI_Dims_create(context.size(), 2, dims.data());
+    coords[1] = context.rank()/dims[0];
+    coords[0] = context.rank() - coords[1]*dims[0];
+    // make 2 domains per rank
+    std::vector<domain> domains{
+        make_domain(context.rank(), 0, coords),
+        make_domain(context.rank(), 1, coords)};
+    halo_gen gen{arr{0,0}, arr{dims[0]*DIM-1,dims[1]*DIM-1}, halos, periodic};
+    auto pattern = make_pattern<structured::grid>(context, gen, domains);
+    // 3-component fields with planar (x or y fastest) and interleaved memory layout
+    using planar_x_field    = structured::regular::field_descriptor<int,cpu,domain,2,1,0>;
+    using planar_y_field    = structured::regular::field_descriptor<int,cpu,domain,1,2,0>;
+    using interleaved_field = structured::regular::field_descriptor<int,cpu,domain,1,0,2>;
+    const int nc = 3;
+    const std::array<int,3> offsets{HALO, HALO, 0};
+    const std::array<int,3> extents{HALO*2+DIM, HALO*2+DIM/2, nc};
+    auto value = [](int x, int y, int c) { return (x*1000+y)*4+c; };
+    auto fill_ = [&](auto&& field) {
+        for (int j=0; j<DIM/2; ++j)
+            for (int i=0; i<DIM; ++i)
+                for (int c=0; c<nc; ++c)
+                    field(i,j,c) = value(field.domain().first()[0]+i, field.domain().first()[1]+j, c);
+        return field.use_canonical_wire_layout();
+    };
+    auto check_ = [&](const auto& field) {
+        bool r = true;
+        for (int j=-HALO; j<DIM/2+HALO; ++j)
+        {
+            const auto y = expected(j, dims[1], field.domain().first()[1], field.domain().last()[1], periodic[1]);
+            for (int i=-HALO; i<DIM+HALO; ++i)
+            {
+                const auto x = expected(i, dims[0], field.domain().first()[0], field.domain().last()[0], periodic[0]);
+                for (int c=0; c<nc; ++c)
+                    r = r && (field(i,j,c) == value(x,y,c));
+            }
+        }
+        return r;
+    };
+    const std::size_t size = extents[0]*extents[1]*extents[2];
+    std::vector<int> raw_a(size, -1), raw_b(size, -1), raw_c(size, -1);
+    auto field_a = fill_(planar_x_field(domains[0], raw_a.data(), offsets, extents, nc));
+    auto field_b = fill_(interleaved_field(domains[1], raw_b.data(), offsets, extents, nc));
+    auto co = make_communication_object<decltype(pattern)>(context.get_communicator());
+    co.exchange(pattern(field_a), pattern(field_b)).wait();
+    bool res = true;
+    res = res && check_(field_a);
+    res = res && check_(field_b);
+    auto field_c = fill_(planar_y_field(domains[1], raw_c.data(), offsets, extents, nc));
+    std::fill(raw_a.begin(), raw_a.end(), -1);
+    fill_(field_a);
+    co.exchange(pattern(field_a), pattern(field_c)).wait();
+    res = res && check_(field_a);
+    res = res && check_(field_c);
+    // reduce res
+    bool all_res = false;
+    MPI_Reduce(&res, &all_res, 1, MPI_C_BOOL, MPI_LAND, 0, MPI_COMM_WORLD);
+    if (context.rank() == 0)
+    {
+        EXPECT_TRUE(all_res);
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <ghex/structured/pattern.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <ghex/structured/regular/halo_generator.hpp>
+#include <ghex/transport_layer/mpi/context.hpp>
+#include <ghex/communication_object_2.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <stdexcept>
+#include <vector>
+#include "../utils/structured_test_utils.hpp"
+
+using namespace gridtools::ghex;
+using arr = std::array<int,3>;
+using transport = tl::mpi_tag;
+using factory = tl::context_factory<transport>;
+using domain_descriptor_type = structured::regular::domain_descriptor<int,3>;
+using halo_generator_type = structured::regular::halo_generator<int,3>;
+using footprint_type = halo_generator_type::footprint_type;
+
+constexpr int halo = 1;
+const arr extents{4,4,3};
+
+TEST(stencil_footprint, directions)
+{
+    EXPECT_EQ(footprint_type::full().num_directions(), 26);
+    EXPECT_EQ(footprint_type::faces_and_edges().num_directions(), 18);
+    EXPECT_EQ(footprint_type::faces().num_directions(), 6);
+    EXPECT_TRUE(footprint_type::faces().contains(arr{0,0,-1}));
+    EXPECT_FALSE(footprint_type::faces().contains(arr{1,0,-1}));
+    EXPECT_TRUE(footprint_type::faces_and_edges().contains(arr{1,0,-1}));
+    EXPECT_FALSE(footprint_type::faces_and_edges().contains(arr{1,1,-1}));
+    EXPECT_FALSE(footprint_type::full().contains(arr{0,0,0}));
+
+    const footprint_type user{arr{-1,0,0}, arr{1,0,0}, arr{0,0,0}};
+    EXPECT_EQ(user.num_directions(), 2);
+    EXPECT_TRUE(user.contains(arr{1,0,0}));
+    EXPECT_FALSE(user.contains(arr{0,1,0}));
+    EXPECT_THROW(footprint_type::index(arr{2,0,0}), std::runtime_error);
+}
+
+TEST(stencil_footprint, halo_generator)
+{
+    const domain_descriptor_type d{0, arr{4,4,4}, arr{7,7,7}};
+    const arr g_first{0,0,0};
+    const arr g_last{15,15,15};
+    const std::array<int,6> halos{1,1,1,1,1,1};
+    const std::array<bool,3> periodic{true,true,true};
+    EXPECT_EQ(halo_generator_type(g_first, g_last, halos, periodic)(d).size(), 26u);
+    EXPECT_EQ(halo_generator_type(g_first, g_last, halos, periodic, footprint_type::faces_and_edges())(d).size(),
+        18u);
+    const auto faces = halo_generator_type(g_first, g_last, halos, periodic, footprint_type::faces())(d);
+    ASSERT_EQ(faces.size(), 6u);
+    // each face halo lies outside of the domain in exactly one dimension
+    for (const auto& h : faces)
+    {
+        int outside = 0;
+        for (int i=0; i<3; ++i)
+            if (h.local().first()[i] < 0 || h.local().last()[i] >= 4) ++outside;
+        EXPECT_EQ(outside, 1);
+    }
+    const footprint_type x_only{arr{-1,0,0}, arr{1,0,0}};
+    EXPECT_EQ(halo_generator_type(g_first, g_last, halos, periodic, x_only)(d).size(), 2u);
+}
+
+// four domains per rank (2x2 in the first two dimensions)
+std::vector<domain_descriptor_type> make_domains(int rank)
+{
+    std::vector<domain_descriptor_type> domains;
+    for (int j=0; j<2; ++j)
+        for (int i=0; i<2; ++i)
+        {
+            const arr first{(rank*2+i)*extents[0], j*extents[1], 0};
+            domains.push_back(domain_descriptor_type{rank*4+j*2+i, first,
+                arr{first[0]+extents[0]-1, first[1]+extents[1]-1, extents[2]-1}});
+        }
+    return domains;
+}
+
+TEST(stencil_footprint, exchange)
+{
+    auto context_ptr = factory::create(MPI_COMM_WORLD);
+    auto& context = *context_ptr;
+    const auto domains = make_domains(context.rank());
+    const arr g_last{context.size()*2*extents[0]-1, 2*extents[1]-1, extents[2]-1};
+    const std::array<int,6> halos{halo,halo,halo,halo,halo,halo};
+    const std::array<bool,3> periodic{true,true,false};
+    const auto patterns_full = make_pattern<structured::grid>(context,
+        halo_generator_type(arr{0,0,0}, g_last, halos, periodic), domains);
+    const auto patterns = make_pattern<structured::grid>(context,
+        halo_generator_type(arr{0,0,0}, g_last, halos, periodic, footprint_type::faces()), domains);
+    // no messages to diagonal neighbors
+    EXPECT_LT(num_neighbors(patterns), num_neighbors(patterns_full));
+
+    test_fields<3> f(domains, g_last, halos, periodic);
+    auto co = make_communication_object<std::remove_const_t<decltype(patterns)>>(context.get_communicator());
+    co.exchange(patterns(f(0)), patterns(f(1)), patterns(f(2)), patterns(f(3))).wait();
+
+    // only the face halos are updated
+    for (unsigned int n=0; n<domains.size(); ++n)
+        for (int k=-halo; k<extents[2]+halo; ++k)
+            for (int j=-halo; j<extents[1]+halo; ++j)
+                for (int i=-halo; i<extents[0]+halo; ++i)
+                {
+                    const int outside = (i < 0 || i >= extents[0]) + (j < 0 || j >= extents[1]) +
+                        (k < 0 || k >= extents[2]);
+                    EXPECT_EQ(f.at(n,i,j,k), outside <= 1 ? f.value(n,i,j,k) : -1);
+                }
+}
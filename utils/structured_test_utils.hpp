@@ -0,0 +1,213 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2020, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+#include <ghex/arch_list.hpp>
+#include <ghex/structured/regular/domain_descriptor.hpp>
+#include <ghex/structured/regular/field_descriptor.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <utility>
+#include <vector>
+
+// helpers shared by the tests of structured patterns
+
+// compares two halo maps (recv_halos or send_halos) element by element; the tags are compared only if
+// compare_tags is true
+template<typename Map>
+void compare_halos(const Map& a, const Map& b, bool compare_tags = true)
+{
+    ASSERT_EQ(a.size(), b.size());
+    auto it_b = b.begin();
+    for (const auto& p : a)
+    {
+        EXPECT_EQ(p.first.id, it_b->first.id);
+        EXPECT_EQ(p.first.mpi_rank, it_b->first.mpi_rank);
+        EXPECT_EQ(p.first.address, it_b->first.address);
+        if (compare_tags) { EXPECT_EQ(p.first.tag, it_b->first.tag); }
+        ASSERT_EQ(p.second.size(), it_b->second.size());
+        for (unsigned int i=0; i<p.second.size(); ++i)
+        {
+            EXPECT_TRUE(p.second[i].local().first() == it_b->second[i].local().first());
+            EXPECT_TRUE(p.second[i].local().last() == it_b->second[i].local().last());
+            EXPECT_TRUE(p.second[i].global().first() == it_b->second[i].global().first());
+            EXPECT_TRUE(p.second[i].global().last() == it_b->second[i].global().last());
+        }
+        ++it_b;
+    }
+}
+
+// compares two neighbor domain maps
+template<typename Map>
+void compare_domains(const Map& a, const Map& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    auto it_b = b.begin();
+    for (const auto& p : a)
+    {
+        EXPECT_EQ(p.first, it_b->first);
+        EXPECT_TRUE(p.second.first() == it_b->second.first());
+        EXPECT_TRUE(p.second.last() == it_b->second.last());
+        ++it_b;
+    }
+}
+
+// compares two pattern containers; the tags (and the maximum tag) are compared only if compare_tags is true
+template<typename PatternContainer>
+void compare_patterns(const PatternContainer& a, const PatternContainer& b, bool compare_tags = true)
+{
+    if (compare_tags) { EXPECT_EQ(a.max_tag(), b.max_tag()); }
+    ASSERT_EQ(a.size(), b.size());
+    for (int i=0; i<a.size(); ++i)
+    {
+        EXPECT_EQ(a[i].domain_id(), b[i].domain_id());
+        EXPECT_EQ(a[i].extended_domain_id().mpi_rank, b[i].extended_domain_id().mpi_rank);
+        EXPECT_TRUE(a[i].global_domain().first() == b[i].global_domain().first());
+        EXPECT_TRUE(a[i].global_domain().last() == b[i].global_domain().last());
+        EXPECT_TRUE(a[i].global_first() == b[i].global_first());
+        EXPECT_TRUE(a[i].global_last() == b[i].global_last());
+        compare_halos(a[i].recv_halos(), b[i].recv_halos(), compare_tags);
+        compare_halos(a[i].send_halos(), b[i].send_halos(), compare_tags);
+        compare_domains(a[i].neighbor_domains(), b[i].neighbor_domains());
+    }
+}
+
+// total number of neighbor domains from which the domains of a pattern container receive
+template<typename PatternContainer>
+int num_neighbors(const PatternContainer& pc)
+{
+    int n = 0;
+    for (const auto& p : pc) n += p.recv_halos().size();
+    return n;
+}
+
+// field type with dimension 0 varying fastest
+template<int D, typename Seq = std::make_integer_sequence<int,D>>
+struct test_field_type;
+template<int D, int... Is>
+struct test_field_type<D, std::integer_sequence<int,Is...>>
+{
+    using type = gridtools::ghex::structured::regular::field_descriptor<int, gridtools::ghex::cpu,
+        gridtools::ghex::structured::regular::domain_descriptor<int,D>, (D-1-Is)...>;
+};
+
+// integer fields on D-dimensional domains, holding an encoding of the global coordinate in their interior.
+// The global domain starts at the origin; values outside of the global domain (non-periodic dimensions) are -1.
+template<int D>
+struct test_fields
+{
+    using coordinate_type = std::array<int,D>;
+    using halos_type = std::array<int,2*D>;
+    using domain_descriptor_type = gridtools::ghex::structured::regular::domain_descriptor<int,D>;
+    using field_type = typename test_field_type<D>::type;
+
+    std::vector<domain_descriptor_type> domains;
+    coordinate_type g_last;
+    halos_type halos;
+    std::array<bool,D> periodic;
+    std::vector<std::vector<int>> data;
+    std::vector<field_type> descriptors;
+
+    test_fields(const std::vector<domain_descriptor_type>& d, const coordinate_type& g_last_, const halos_type& halos_,
+        const std::array<bool,D>& periodic_)
+    : domains(d), g_last(g_last_), halos(halos_), periodic(periodic_)
+    {
+        for (unsigned int n=0; n<domains.size(); ++n)
+        {
+            data.emplace_back(size(n), -1);
+            for (int i=0; i<size(n); ++i)
+            {
+                const auto x = coordinate(n, i);
+                if (interior(n, x)) at(n, x) = value(n, x);
+            }
+            coordinate_type offsets, extents;
+            for (int k=0; k<D; ++k)
+            {
+                offsets[k] = halos[2*k];
+                extents[k] = extent(n, k);
+            }
+            descriptors.push_back(field_type{domains[n], data[n].data(), offsets, extents});
+        }
+    }
+
+    // field value at local coordinate x (-1 outside of the global domain)
+    int value(int n, const coordinate_type& x) const
+    {
+        int res = 0;
+        for (int k=0; k<D; ++k)
+        {
+            int y = domains[n].first()[k]+x[k];
+            if (periodic[k]) y = (y + g_last[k]+1) % (g_last[k]+1);
+            if (y < 0 || y > g_last[k]) return -1;
+            res = res*100 + y;
+        }
+        return res;
+    }
+
+    int& at(int n, const coordinate_type& x)
+    {
+        int index = 0;
+        for (int k=D-1; k>=0; --k) index = index*extent(n, k) + x[k]+halos[2*k];
+        return data[n][index];
+    }
+
+    template<typename... Is>
+    int value(int n, Is... is) const { return value(n, coordinate_type{is...}); }
+
+    template<typename... Is>
+    int& at(int n, Is... is) { return at(n, coordinate_type{is...}); }
+
+    field_type& operator()(int n) { return descriptors[n]; }
+
+    // true if all values, including the halos, are set
+    bool check()
+    {
+        bool res = true;
+        for (unsigned int n=0; n<domains.size(); ++n)
+            for (int i=0; i<size(n); ++i)
+            {
+                const auto x = coordinate(n, i);
+                res = res && at(n, x) == value(n, x);
+            }
+        return res;
+    }
+
+private:
+    // extent of dimension k of the memory of field n (including the halos)
+    int extent(int n, int k) const
+    {
+        return domains[n].last()[k]-domains[n].first()[k]+1 + halos[2*k]+halos[2*k+1];
+    }
+
+    int size(int n) const
+    {
+        int s = 1;
+        for (int k=0; k<D; ++k) s *= extent(n, k);
+        return s;
+    }
+
+    // local coordinate of the i-th value of field n
+    coordinate_type coordinate(int n, int i) const
+    {
+        coordinate_type x;
+        for (int k=0; k<D; ++k)
+        {
+            x[k] = i%extent(n, k) - halos[2*k];
+            i /= extent(n, k);
+        }
+        return x;
+    }
+
+    bool interior(int n, const coordinate_type& x) const
+    {
+        for (int k=0; k<D; ++k)
+            if (x[k] < 0 || x[k] > domains[n].last()[k]-domains[n].first()[k]) return false;
+        return true;
+    }
+};